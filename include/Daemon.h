@@ -0,0 +1,329 @@
+/******************************************************************************//*!
+* @File          Daemon.h
+* 
+* @Title         Header file for LZW daemon and its client.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      POSIX
+* 
+* @Description   This header file defines the prototypes of classes and functions
+*                for `lzwd`, a long-running service compressing and
+*                decompressing data sent over a Unix domain socket, and for
+*                its client used by `Encoder` and `Decoder` utilities.
+* 
+*//*******************************************************************************/ 
+
+#pragma once
+
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#include "Encoder.h"
+#include "Decoder.h"
+
+
+/* Every message between lzwd and its clients, request or response, is
+   a header followed by a payload:
+       Byte 0-3     Magic "LZWD"
+       Byte 4       Operation of request, status of response
+       Byte 5       Bit length of codes; in response to compression,
+                    bit length selected for the stream
+       Byte 6       Flags (DAEMON_FLAG_*)
+       Byte 7       Reserved (0)
+       Byte 8-15    Size of payload, most significant byte first
+   Payload is text or compressed data, or an error message if status
+   is not DAEMON_OK. A connection carries any number of requests,
+   one after another. */
+const char         DAEMON_MAGIC[]          = "LZWD";
+const size_t       DAEMON_HEADER_SIZE      = 16;
+const size_t       DAEMON_MAX_PAYLOAD_SIZE = (size_t) 1 << 28;
+const unsigned int DAEMON_FLAG_FLEXIBLE    = 1;
+
+/* Environment variable naming socket of lzwd. Once set, `Encoder` and
+   `Decoder` utilities hand their work over to lzwd. */
+const char         DAEMON_SOCKET_ENV[]     = "LZWD_SOCKET";
+
+/* Compressed data is decoded chunk by chunk, so that data expanding
+   beyond DAEMON_MAX_PAYLOAD_SIZE is refused early. */
+const size_t       DAEMON_DECODE_CHUNK_SIZE = 4096;
+
+/* A client stalled within a request, or not reading its response, for
+   so long is disconnected, so that it does not hold its buffers. */
+const unsigned int DAEMON_IO_TIMEOUT_SECONDS = 30;
+
+/* Payload of a request grows by so much as its bytes arrive, so that
+   a header alone claiming a large payload allocates nothing. Buffers
+   of a connection grown beyond it are released once a response is
+   sent, so that an idle connection holds no large buffer. */
+const size_t       DAEMON_BUFFER_STEP_SIZE = STREAM_CHUNK_SIZE;
+
+/* Peer closing a connection must not raise SIGPIPE. */
+#ifdef MSG_NOSIGNAL
+const int          DAEMON_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int          DAEMON_SEND_FLAGS = 0;
+#endif
+
+
+/******************************************************************************
+* @Enum 		DaemonOperation
+*
+* @Description	Operation requested from lzwd.
+******************************************************************************/
+enum DaemonOperation
+{
+    DAEMON_COMPRESS   = 'C',
+    DAEMON_DECOMPRESS = 'D'
+};
+
+
+/******************************************************************************
+* @Enum 		DaemonStatus
+*
+* @Description	Outcome of a request.
+*               DAEMON_OK           Request is served.
+*               DAEMON_ERROR        Request is refused or data is corrupt.
+*               DAEMON_UNAVAILABLE  lzwd can not serve request, e.g. it is
+*                                   not running; never sent by lzwd.
+******************************************************************************/
+enum DaemonStatus
+{
+    DAEMON_OK          = 0,
+    DAEMON_ERROR       = 1,
+    DAEMON_UNAVAILABLE = 2
+};
+
+
+// Socket path of lzwd, from DAEMON_SOCKET_ENV or default for the user
+std::string DaemonSocketPath();
+
+// Format header of a message
+void FormatHeader(char *pchHeader, unsigned char uchType,
+                  unsigned int uiBitLength, unsigned int uiFlags, size_t uiSize);
+
+// Parse header of a message
+bool ParseHeader(const char *pchHeader, unsigned char &uchType,
+                 unsigned int &uiBitLength, unsigned int &uiFlags,
+                 size_t &uiSize);
+
+// Send a message to a socket
+bool SendMessage(int hSocket, unsigned char uchType, unsigned int uiBitLength,
+                 unsigned int uiFlags, const char *pchPayload, size_t uiSize);
+
+// Receive header of a message from a socket
+bool ReceiveHeader(int hSocket, unsigned char &uchType,
+                   unsigned int &uiBitLength, unsigned int &uiFlags,
+                   size_t &uiSize);
+
+// Receive exactly the given number of bytes from a socket
+bool ReceiveBytes(int hSocket, char *pchData, size_t uiSize);
+
+
+/******************************************************************************
+* @Class		DaemonClient
+*
+* @Description	Class representing client of lzwd.
+* 				This class defines attributes and functionalities
+*               for sending files to lzwd. Files are read and written by
+*               the client; lzwd only ever sees their contents.
+******************************************************************************/
+class DaemonClient
+{
+private:
+    std::string     m_pszSocketPath;
+    int             m_hSocket;
+    
+    // Connect to lzwd, unless connected already
+    bool Connect();
+    
+    // Send a request and receive its response
+    DaemonStatus Request(DaemonOperation eOperation, unsigned int uiBitLength,
+                         unsigned int uiFlags, const std::string &pszInput,
+                         std::string &pszOutput, unsigned int &uiCodeLength);
+    
+    // DaemonClient owns its socket, hence it can not be copied
+    DaemonClient(const DaemonClient &);
+    DaemonClient &operator=(const DaemonClient &);
+    
+public:
+    // Constructor
+    DaemonClient(std::string pszSocketPath=DaemonSocketPath())
+    {
+        m_pszSocketPath = pszSocketPath;
+        m_hSocket       = -1;
+    }
+    
+    // Destructor
+    ~DaemonClient() { Close(); }
+    
+    // Disconnect from lzwd
+    void Close();
+    
+    // Public getter
+    std::string GetSocketPath() { return m_pszSocketPath; }
+    
+    // LZW encoding of a memory buffer by lzwd
+    DaemonStatus Compress(const std::string &pszText, unsigned int uiBitLength,
+                          ParseMode eParseMode, std::string &pszCodes,
+                          unsigned int &uiCodeLength);
+    
+    // LZW decoding of a memory buffer by lzwd
+    DaemonStatus Decompress(const std::string &pszCodes,
+                            unsigned int uiBitLength, std::string &pszText);
+    
+    // LZW encoding of a file by lzwd
+    DaemonStatus Encode(std::string pszTextFile, unsigned int uiBitLength,
+                        ParseMode eParseMode, unsigned int &uiCodeLength);
+    
+    // LZW decoding of a file by lzwd
+    DaemonStatus Decode(std::string pszCompressedFile, unsigned int uiBitLength);
+};
+
+
+class Daemon;
+
+
+/******************************************************************************
+* @Struct		DaemonConnection
+*
+* @Description	Connection of a client to lzwd. Its socket never blocks:
+*               requests are received and responses sent piece by piece,
+*               as far as the socket allows, by the thread watching
+*               connections, so a slow client holds no worker.
+*               Header holds the request until it is received, and then
+*               the response until it is sent.
+******************************************************************************/
+struct DaemonConnection
+{
+    int             hSocket;        // Connected socket
+    char            achHeader[DAEMON_HEADER_SIZE];  // Header of message
+    size_t          uiDone;         // Bytes of message received or sent
+    unsigned char   uchOperation;   // Operation of request
+    unsigned int    uiBitLength;    // Bit length of codes of request
+    unsigned int    uiFlags;        // Flags of request
+    size_t          uiPayloadSize;  // Size of payload of request
+    std::string     pszPayload;     // Payload of request, as far as received
+    std::string     pszResponse;    // Payload of response
+    bool            bIsSending;     // Whether response is being sent
+    bool            bIsClosing;     // Whether to close once response is sent
+    time_t          tLastActive;    // Time of last bytes received or sent
+};
+
+
+/******************************************************************************
+* @Struct		DaemonWorker
+*
+* @Description	Worker thread of lzwd, serving one complete request at
+*               a time. Encoder and Decoder are kept from request to
+*               request, and are reset as soon as a payload is coded,
+*               so that the next request starts coding straight away.
+******************************************************************************/
+struct DaemonWorker
+{
+    Daemon          *pDaemon;       // Daemon owning worker
+    pthread_t       hThread;        // Thread of worker
+    Encoder         *pEncoder;      // Encoder with a fresh Trie
+    Decoder         *pDecoder;      // Decoder with a fresh Map
+    std::string     pszOutput;      // Payload of response
+};
+
+
+/******************************************************************************
+* @Class		Daemon
+*
+* @Description	Class representing lzwd.
+* 				This class defines attributes and functionalities
+*               for serving compression and decompression requests
+*               over a Unix domain socket.
+*               One thread watches the socket and all connections, and
+*               receives requests and sends responses without blocking.
+*               Only complete requests are queued, and all requests
+*               completed together are spread across worker threads at
+*               once. A served connection is watched again, first to send
+*               its response, then for its next request.
+******************************************************************************/
+class Daemon
+{
+private:
+    std::string                     m_pszSocketPath;
+    unsigned int                    m_uiWorkerCount;
+    int                             m_hListenSocket;
+    int                             m_ahWakePipe[2];
+    std::vector<DaemonWorker*>      m_vpWorkers;
+    std::vector<DaemonConnection*>  m_vpConnections;
+    pthread_mutex_t                 m_hMutex;
+    pthread_cond_t                  m_hRequestReady;
+    std::deque<DaemonConnection*>   m_qpRequests;
+    std::vector<DaemonConnection*>  m_vpServed;
+    bool                            m_bIsStopping;
+    volatile sig_atomic_t           m_bIsStopRequested;
+    
+    // Create, bind and listen on Unix domain socket
+    bool Listen();
+    
+    // Accept all pending connections
+    void AcceptConnections();
+    
+    // Receive as much of a request as the socket allows
+    bool ReceiveRequest(DaemonConnection *pConnection);
+    
+    // Send as much of a response as the socket allows
+    bool SendResponse(DaemonConnection *pConnection);
+    
+    // Take next connection with a complete request, waiting for one
+    DaemonConnection* NextRequest();
+    
+    // Hand a served connection back to send its response
+    void ReturnConnection(DaemonConnection *pConnection);
+    
+    // Code payload of a complete request
+    void Serve(DaemonWorker *pWorker, DaemonConnection *pConnection);
+    
+    // Code payload of a request
+    DaemonStatus Compress(DaemonWorker *pWorker, const std::string &pszInput,
+                          unsigned int uiBitLength, unsigned int uiFlags,
+                          unsigned int &uiCodeLength);
+    DaemonStatus Decompress(DaemonWorker *pWorker, const std::string &pszInput,
+                            unsigned int uiBitLength);
+    
+    // Entry point of worker threads
+    static void* RunWorker(void *pArgument);
+    
+    // Daemon owns its sockets and threads, hence it can not be copied
+    Daemon(const Daemon &);
+    Daemon &operator=(const Daemon &);
+    
+public:
+    // Constructor
+    // Note: Workers and their dictionaries are created by Start()
+    Daemon(std::string pszSocketPath=DaemonSocketPath(),
+           unsigned int uiWorkerCount=1);
+    
+    // Destructor
+    ~Daemon();
+    
+    // Public getter
+    std::string GetSocketPath() { return m_pszSocketPath; }
+    unsigned int GetWorkerCount() { return m_uiWorkerCount; }
+    
+    // Listen on socket and start workers with preallocated dictionaries
+    bool Start();
+    
+    // Serve requests until Stop() is called
+    void Run();
+    
+    // Ask Run() to return
+    // Note: Safe to call from a signal handler
+    void Stop();
+};
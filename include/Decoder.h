@@ -18,34 +18,82 @@
 
 #include <iostream>
 #include <string.h>
+#include <string>
 #include <fstream>
 #include <cmath>
 #include <stdint.h>
-#include <map>
+#include <vector>
+#include <algorithm>
 #include <cstdlib>
 	
 #include "FileStream.h"
 
 
+/* Marks a missing 'word' of Decoder. */
+const int32_t DECODE_NONE = -1;
+
+
+/******************************************************************************
+* @Struct		CodeWord
+*
+* @Description	Entry of Decoder's Map: word of another code extended by
+*               one symbol. Words are spelled from their last symbol back
+*               to the first, so none is stored as a whole, and entries
+*               are overwritten in place from stream to stream.
+******************************************************************************/
+struct CodeWord
+{
+    uint32_t      uiLength;       // Length of word
+    uint16_t      u2Prefix;       // Code of word without its last symbol,
+                                  // unused for words of single characters
+    unsigned char uchFirst;       // First symbol of word
+    unsigned char uchSymbol;      // Last symbol of word
+};
+
+
 /******************************************************************************
 * @Class		Decoder
 *
 * @Description	Class representing LZW Decoder.
 * 				This class defines attributes and functionalities
 *               for LZW Decoder.
+*               Decoder can be driven incrementally (Reset, Update, Finish)
+*               on memory buffers, or at once on streams and files.
 ******************************************************************************/
 class Decoder
 {
 private:
-    unsigned int    m_uiBitLength;
-    unsigned int    m_uiMaxTableSize;
-    static uint16_t s_u2Code;
+    unsigned int                    m_uiBitLength;
+    unsigned int                    m_uiCodeLength;
+    unsigned int                    m_uiMaxTableSize;
+    uint16_t                        m_u2Code;
+    bool                            m_bIsOverflow;
+    bool                            m_bIsCorrupt;
+    bool                            m_bHasFlushCode;
+    bool                            m_bHasStoredCode;
+    bool                            m_bIsStoredBlock;
+    size_t                          m_uiStoredSize;
+    std::string                     m_pszStoredLength;
+    std::vector<CodeWord>           m_vCodeWords;
+    int32_t                         m_iWord;
+    DecryptStream                   m_decin;
+    
+    // Initialise a Map with ASCII characters
+    void InitialiseMap();
+    
+    // Append word of a code to text
+    void WriteWord(uint16_t u2Code, std::string &pszText);
     
-    // Initialise a Trie with ASCII characters
-    void InitialiseMap(std::map<uint16_t, std::string> &CodeWordMap);
+    // Read header and fix bit length of codes
+    bool ReadHeader();
+    
+    // Copy text of a stored block, which may be split across chunks
+    bool ReadStoredBlock(std::string &pszText);
     
 public:
     // Constructor
+    // Note: Bit length is read from header of compressed data;
+    //       the one given here only applies to data without header
     Decoder(unsigned int uiBitLength=16)
     {
         if (uiBitLength > 16)
@@ -53,22 +101,35 @@ public:
                       << std::endl;
         
         m_uiBitLength    = uiBitLength;
-        m_uiMaxTableSize = (unsigned int) pow(2.0, uiBitLength);
+        
+        Reset();
     }
     
     // Destructor
     ~Decoder() {}
     
     // Public setter
-    void SetBitLength(unsigned int uiBitLength)
-    {
-        m_uiBitLength    = uiBitLength;
-        m_uiMaxTableSize = (unsigned int) pow(2.0, uiBitLength);
-    }
+    // Note: New bit length takes effect from the next Reset()
+    void SetBitLength(unsigned int uiBitLength) { m_uiBitLength = uiBitLength; }
     
     // Public getter
     unsigned int GetBitLength() { return m_uiBitLength; }
     
-    // LZW decoding
-    void Decode(std::string pszCompressedFile);
+    // Bit length of codes in current stream, 0 until header is read
+    unsigned int GetCodeLength() { return m_uiCodeLength; }
+    
+    // Start decoding a new code stream with a fresh Map
+    void Reset();
+    
+    // Decode a chunk of encrypted data, appending text to a buffer
+    bool Update(const char *pchData, size_t uiSize, std::string &pszText);
+    
+    // Check whether code stream ended on a code boundary
+    bool Finish();
+    
+    // LZW decoding of a stream
+    bool Decode(std::istream &CompressedStream, std::ostream &TextStream);
+    
+    // LZW decoding of a file
+    bool Decode(std::string pszCompressedFile);
 };
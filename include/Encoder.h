@@ -18,58 +18,272 @@
 
 #include <iostream>
 #include <string.h>
+#include <string>
 #include <fstream>
 #include <cmath>
 #include <stdint.h>
 #include <cstdlib>
+#include <vector>
+#include <algorithm>
 
 #include "Trie.h"
 #include "FileStream.h"
 
 
+/* Bit length requesting Encoder to select one by sampling the text. */
+const unsigned int AUTO_BIT_LENGTH = 0;
+
+/* Bit lengths of codes supported by Encoder. Codes are held in uint16_t,
+   and codes shorter than 8 bits can not represent every symbol. */
+const unsigned int MIN_BIT_LENGTH = 8;
+const unsigned int MAX_BIT_LENGTH = 16;
+
+/* Bit lengths tried, every supported one, and amount of text sampled
+   by automatic selection. */
+const unsigned int AUTO_MIN_BIT_LENGTH = MIN_BIT_LENGTH;
+const unsigned int AUTO_MAX_BIT_LENGTH = MAX_BIT_LENGTH;
+const size_t       AUTO_SAMPLE_SIZE    = 1 << 20;
+
+/* Codes longer than 8 bits are output block by block. A block whose codes
+   would take more space than the block itself is stored as is, costing at
+   most STORED_BLOCK_OVERHEAD bytes besides the text. */
+const size_t       STORED_BLOCK_SIZE     = 1 << 15;
+const size_t       STORED_BLOCK_OVERHEAD = 5;
+
+
+/******************************************************************************
+* @Enum 		ParseMode
+*
+* @Description	Strategy used by LZW Encoder to split text into words.
+*               PARSE_GREEDY    Always output the longest word found in Trie.
+*               PARSE_FLEXIBLE  Output the prefix of longest word which lets
+*                               the next word reach farthest into the text,
+*                               once Trie is full; until then, output is the
+*                               same as PARSE_GREEDY, as shorter words would
+*                               cost Trie words worth more than they save.
+*                               Slower, but gives smaller output on text
+*                               which fills Trie; compressed data is decoded
+*                               by the same Decoder.
+******************************************************************************/
+enum ParseMode
+{
+    PARSE_GREEDY,
+    PARSE_FLEXIBLE
+};
+
+
 /******************************************************************************
 * @Class		Encoder
 *
 * @Description	Class representing LZW Encoder.
 * 				This class defines attributes and functionalities
 *               for LZW Encoder.
+*               Encoder can be driven incrementally (Reset, Update, Finish)
+*               on memory buffers, or at once on streams and files.
 ******************************************************************************/
 class Encoder
 {
 private:
     unsigned int    m_uiBitLength;
+    unsigned int    m_uiCodeLength;
     unsigned int    m_uiMaxTableSize;
-    static uint16_t s_u2Code;
+    uint16_t        m_u2Code;
+    bool            m_bIsOverflow;
+    Trie            m_Trie;
+    Node            *m_apSymbolNodes[256];
+    Node            *m_pWord;
+    Node            *m_pFlushedWord;
+    ParseMode       m_eParseMode;
+    bool            m_bIsFlexible;
+    std::string     m_pszLookahead;
+    std::vector<Node*> m_vpMatch;
+    std::string     m_pszSample;
+    bool            m_bIsHeaderWritten;
+    bool            m_bHasStoredBlocks;
+    std::string     m_pszBlock;
+    std::vector<Node*> m_vpAddedNodes;
+    size_t          m_uiBlockStart;
+    EncryptStream   m_BlockStream;
+    uint16_t        m_u2BlockCode;
+    bool            m_bWasOverflow;
+    EncryptStream   m_encout;
+    
+    // MultiEncoder drives the greedy loop of several Encoders in lockstep
+    friend class MultiEncoder;
+    
+    // Encoder owns its Trie, hence it can not be copied
+    Encoder(const Encoder &);
+    Encoder &operator=(const Encoder &);
     
     // Initialise a Trie with ASCII characters
     void InitialiseTrie(Node *pRootNode);
     
+    // Assign next code to ('word' + symbol), if Trie is not full
+    void AssignCode(Node *pWord, char chSymbol);
+    
+    // Add ('word' + symbol) into Trie, recording it for EncodeBlock()
+    void AddNode(Node *pWord, char chSymbol);
+    
+    // Length of longest word in Trie matching beginning of text
+    size_t MatchLength(const char *pchText, size_t uiSize);
+    
+    // Encode buffered text using flexible parsing
+    Node* ParseFlexible(bool bIsFinal);
+    
+    // Select bit length of codes by trial encoding of a sample
+    void SelectCodeLength(const char *pchSample, size_t uiSize);
+    
+    // Fix bit length of codes and write header
+    void StartCodeStream(unsigned int uiCodeLength);
+    
+    // Start code stream before a complete sample is supplied
+    void EndSampling(std::string &pszCodes, bool bIsFinal);
+    
+    // Start code stream for a text supplied at once
+    void StartText(const char *pchText, size_t uiSize);
+    
+    // Encode a chunk of text data after header
+    void EncodeText(const char *pchData, size_t uiSize);
+    
+    // Extend word output at the last flush point by the symbol after it
+    void ExtendFlushedWord(char chSymbol);
+    
+    // Encode a symbol using greedy parsing
+    void EncodeSymbol(char chSymbol)
+    {
+        Node *pNewWord;
+        
+        // Start a 'word' with first extracted character
+        if (m_pWord == NULL)
+        {
+            m_pWord = m_apSymbolNodes[(unsigned char) chSymbol];
+            return;
+        }
+        
+        // If new word exists in Trie,
+        // then update 'word' with new word
+        pNewWord = m_pWord->SearchChildNode(chSymbol);
+        if (pNewWord != NULL)
+        {
+            m_pWord = pNewWord;
+            return;
+        }
+        
+        // If new word does not exist in Trie,
+        // output the code for 'word'
+        m_encout << m_pWord->GetCode();
+        
+        // Add new word into Trie, if Trie is not full
+        if (m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
+        {
+            AddNode(m_pWord, chSymbol);
+            if (m_u2Code != (m_uiMaxTableSize-1))
+                m_u2Code++;
+            else
+                m_bIsOverflow = true;
+        }
+        
+        // Update 'word' with new extracted character
+        m_pWord = m_apSymbolNodes[(unsigned char) chSymbol];
+    }
+    
+    // Output the code for pending 'word', leaving it to be extended
+    // by the symbol that follows
+    void EndWord();
+    
+    // Encode a block, or store it as is if codes do not pay off
+    // Note: A block ending at a flush point is padded to a byte boundary
+    void EncodeBlock(const char *pchBlock, size_t uiSize, std::string &pszCodes,
+                     bool bIsFlushed=false);
+    
+    // Start trial encoding of a block, unless it is stored right away
+    bool BeginBlock(const char *pchBlock, size_t uiSize, std::string &pszCodes);
+    
+    // End trial encoding of a block, storing it if codes do not pay off
+    void EndBlock(const char *pchBlock, size_t uiSize, std::string &pszCodes,
+                  bool bIsFlushed=false);
+    
+    // Output a block as is
+    void StoreBlock(const char *pchBlock, size_t uiSize);
+    
 public:
     // Constructor
+    // Note: AUTO_BIT_LENGTH selects bit length separately for every stream;
+    //       an unsupported bit length is refused in favour of 16
     Encoder(unsigned int uiBitLength=16)
     {
-        // LZW Encoder does not support bit length greater than 16.
-        if (uiBitLength > 16)
-            std::cerr << "Bit Length should not be greater than 16."
-                      << std::endl;
+        m_uiBitLength    = MAX_BIT_LENGTH;
+        m_eParseMode     = PARSE_GREEDY;
         
-        m_uiBitLength    = uiBitLength;
-        m_uiMaxTableSize = (unsigned int) pow(2.0, uiBitLength);
+        SetBitLength(uiBitLength);
+        Reset();
     }
     
     // Destructor
     ~Encoder() {}
     
+    // Check whether Encoder supports a bit length
+    static bool IsValidBitLength(unsigned int uiBitLength)
+    {
+        return uiBitLength == AUTO_BIT_LENGTH ||
+               (uiBitLength >= MIN_BIT_LENGTH && uiBitLength <= MAX_BIT_LENGTH);
+    }
+    
+    // Parse a bit length given on commandline: `auto`, or 8 to 16
+    static bool ParseBitLength(const std::string &pszArgument,
+                               unsigned int &uiBitLength);
+    
     // Public setter
+    // Note: New bit length takes effect from the next Reset();
+    //       an unsupported bit length is refused, keeping the current one
     void SetBitLength(unsigned int uiBitLength)
     {
-        m_uiBitLength    = uiBitLength;
-        m_uiMaxTableSize = (unsigned int) pow(2.0, uiBitLength);
+        // LZW Encoder supports codes of 8 to 16 bits only.
+        if (!IsValidBitLength(uiBitLength))
+        {
+            std::cerr << "Bit Length should be between " << MIN_BIT_LENGTH
+                      << " and " << MAX_BIT_LENGTH << ", or `auto`."
+                      << std::endl;
+            return;
+        }
+        
+        m_uiBitLength = uiBitLength;
     }
     
+    // Note: New parse mode takes effect from the next Reset()
+    void SetParseMode(ParseMode eParseMode) { m_eParseMode = eParseMode; }
+    
     // Public getter
     unsigned int GetBitLength() { return m_uiBitLength; }
     
-    // LZW encoding
-    void Encode(std::string pszTextFile);
+    // Bit length of codes in current stream,
+    // AUTO_BIT_LENGTH until it is selected
+    unsigned int GetCodeLength() { return m_uiCodeLength; }
+    ParseMode GetParseMode() { return m_eParseMode; }
+    
+    // Start a new code stream with a fresh Trie
+    void Reset();
+    
+    // Construct Trie nodes in advance for the largest Trie
+    // of current bit length
+    void Reserve();
+    
+    // Encode a chunk of text data, appending codes to a buffer
+    // Note: With AUTO_BIT_LENGTH, no codes are output
+    //       until AUTO_SAMPLE_SIZE bytes of text are supplied;
+    //       otherwise codes are output block by block
+    void Update(const char *pchData, size_t uiSize, std::string &pszCodes);
+    
+    // Output codes for all text supplied so far and pad to a byte
+    // boundary, keeping Trie for the text that follows
+    void Flush(std::string &pszCodes);
+    
+    // Output the code for remaining 'word' and pad to a byte boundary
+    void Finish(std::string &pszCodes);
+    
+    // LZW encoding of a stream
+    bool Encode(std::istream &TextStream, std::ostream &CompressedStream);
+    
+    // LZW encoding of a file
+    bool Encode(std::string pszTextFile);
 };
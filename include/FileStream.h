@@ -1,7 +1,7 @@
 /******************************************************************************//*!
 * @File          FileStream.h
 * 
-* @Title         Header file for special input and output file streams.
+* @Title         Header file for special input and output code streams.
 * 
 * @Author        Chetan Borse
 * 
@@ -10,41 +10,134 @@
 * @Platform      ?
 * 
 * @Description   This header file defines the prototypes of classes and functions 
-*                for special input/output file streams 
+*                for special input/output code streams 
 *                required for reading/writing encrypted data.
+*                Code streams work on memory buffers, so that the same 
+*                LZW engine serves files and in-process callers.
 * 
 *//*******************************************************************************/ 
 
 #pragma once
 
 #include <iostream>
-#include <fstream>
+#include <string>
+#include <stddef.h>
 #include <stdint.h>
 
 
+/* Size of chunks in which streams and files are read. */
+const size_t STREAM_CHUNK_SIZE = 65536;
+
+/* Compressed data starts with a header of STREAM_HEADER_SIZE bytes:
+   magic "LZW", format version and bit length of codes.
+   Data written before the header existed starts with a zero byte (the high
+   byte of a 16 bit code below 256) and is read as 16 bit codes. */
+const char         STREAM_MAGIC[]     = "LZW";
+const unsigned int STREAM_VERSION     = 3;
+const size_t       STREAM_HEADER_SIZE = 5;
+const unsigned int LEGACY_CODE_LENGTH = 16;
+
+/* From format version 2, codes longer than 8 bits reserve FLUSH_CODE:
+   it marks a sync flush point, after which codes restart on a byte
+   boundary.
+   From format version 3, they also reserve STORED_CODE: it is followed,
+   from the next byte boundary, by a 2 byte (big endian) length and as many
+   bytes of text stored as is. Codes restart after them without extending
+   the word output before the stored text.
+   New words are numbered from FIRST_WORD_CODE onwards (257 in version 2). */
+const uint16_t     FLUSH_CODE         = 256;
+const uint16_t     STORED_CODE        = 257;
+const uint16_t     FIRST_WORD_CODE    = 258;
+const size_t       STORED_LENGTH_SIZE = 2;
+
+/* Progress of reading header of compressed data */
+enum HeaderStatus
+{
+    HEADER_PENDING,
+    HEADER_READ,
+    HEADER_CORRUPT
+};
+
+
 /******************************************************************************
 * @Class		EncryptStream
 *
 * @Description	Class representing EncryptStream.
 * 				This class defines attributes and functionalities
-*               required for writing encrypted data into file.
+*               required for writing encrypted data into a buffer.
+*               Codes are packed with N bits each, most significant bit
+*               first; bits not yet forming a byte are kept until the next
+*               code or Flush().
 ******************************************************************************/
 class EncryptStream
 {
 private:
-    std::ostream &m_OutStream;
-    
+    std::string  *m_pOutBuffer;
+    unsigned int m_uiCodeLength;
+    uint32_t     m_u4Bits;
+    unsigned int m_uiBitCount;
+
 public:
     // Constructor
-    EncryptStream(std::ostream &OutStream) : m_OutStream(OutStream) {}
-    
+    EncryptStream(unsigned int uiCodeLength=16)
+    {
+        m_pOutBuffer = NULL;
+        Reset(uiCodeLength);
+    }
+
+    // Discard pending bits and start writing N bit codes
+    void Reset(unsigned int uiCodeLength)
+    {
+        m_uiCodeLength = uiCodeLength;
+        m_u4Bits       = 0;
+        m_uiBitCount   = 0;
+    }
+
+    // Select buffer to which encrypted data is appended
+    void Attach(std::string &OutBuffer) { m_pOutBuffer = &OutBuffer; }
+
+    // Append header of compressed data
+    void WriteHeader()
+    {
+        m_pOutBuffer->append(STREAM_MAGIC, 3);
+        m_pOutBuffer->push_back((char) STREAM_VERSION);
+        m_pOutBuffer->push_back((char) m_uiCodeLength);
+    }
+
     // Operator overloading for '<<'
-    // Note: This operator writes encrypted code into file
+    // Note: This operator appends encrypted code to buffer
     //       in Big Endien notation
     void operator<<(uint16_t u2Code)
     {
-        m_OutStream.put((u2Code >> 8) & 0xff);
-        m_OutStream.put(u2Code & 0xff);
+        m_u4Bits      = (m_u4Bits << m_uiCodeLength) | u2Code;
+        m_uiBitCount += m_uiCodeLength;
+
+        while (m_uiBitCount >= 8)
+        {
+            m_uiBitCount -= 8;
+            m_pOutBuffer->push_back((char) ((m_u4Bits >> m_uiBitCount) & 0xff));
+        }
+    }
+
+    // Check whether next code starts on a byte boundary
+    bool IsAligned() const { return m_uiBitCount == 0; }
+
+    // Append bytes as is
+    // Note: Stream must be aligned to a byte boundary
+    void WriteBytes(const char *pchData, size_t uiSize)
+    {
+        m_pOutBuffer->append(pchData, uiSize);
+    }
+
+    // Pad pending bits with zeros up to a byte boundary
+    void Flush()
+    {
+        if (m_uiBitCount > 0)
+            m_pOutBuffer->push_back((char) ((m_u4Bits << (8 - m_uiBitCount))
+                                            & 0xff));
+
+        m_u4Bits     = 0;
+        m_uiBitCount = 0;
     }
 };
 
@@ -54,33 +147,199 @@ public:
 *
 * @Description	Class representing DecryptStream.
 * 				This class defines attributes and functionalities
-*               required for reading encrypted data from file.
+*               required for reading encrypted data from buffers.
+*               Encrypted data may arrive in chunks of any size; a code
+*               or header split across two chunks is completed by the
+*               next Feed().
 ******************************************************************************/
 class DecryptStream
 {
 private:
-    std::istream &m_InStream;
-    
+    const char   *m_pchData;
+    size_t       m_uiSize;
+    unsigned int m_uiCodeLength;
+    uint32_t     m_u4Bits;
+    unsigned int m_uiBitCount;
+    unsigned int m_uiVersion;
+    bool         m_bIsHeaderRead;
+    std::string  m_pszHeader;
+
 public:
     // Constructor
-    DecryptStream(std::istream &InStream) : m_InStream(InStream) {}
-    
+    DecryptStream(unsigned int uiCodeLength=16)
+    {
+        Reset(uiCodeLength);
+    }
+
+    // Discard buffered data and any partially read code
+    void Reset(unsigned int uiCodeLength)
+    {
+        m_pchData       = NULL;
+        m_uiSize        = 0;
+        m_uiCodeLength  = uiCodeLength;
+        m_u4Bits        = 0;
+        m_uiBitCount    = 0;
+        m_uiVersion     = 0;
+        m_bIsHeaderRead = false;
+        m_pszHeader.clear();
+    }
+
+    // Start reading N bit codes from the next byte
+    void SetCodeLength(unsigned int uiCodeLength)
+    {
+        m_uiCodeLength = uiCodeLength;
+    }
+
+    // Public getters, valid once ReadHeader() returned HEADER_READ
+    // Note: Data written before the header existed is version 0
+    unsigned int GetVersion() const { return m_uiVersion; }
+    unsigned int GetCodeLength() const { return m_uiCodeLength; }
+
+    // Check whether stream reserves FLUSH_CODE
+    bool HasFlushCode() const { return m_uiVersion >= 2 && m_uiCodeLength > 8; }
+
+    // Check whether stream reserves STORED_CODE
+    bool HasStoredCode() const { return m_uiVersion >= 3 && m_uiCodeLength > 8; }
+
+    // Code of first new word
+    uint16_t GetFirstWordCode() const
+    {
+        if (HasStoredCode())
+            return FIRST_WORD_CODE;
+
+        return HasFlushCode() ? FLUSH_CODE + 1 : 256;
+    }
+
+    // Check whether data ended within the header
+    bool HasPartialHeader() const
+    {
+        return !m_bIsHeaderRead && !m_pszHeader.empty();
+    }
+
+    // Read header of compressed data and fix bit length of codes.
+    // Data starting with a zero byte has no header and holds 16 bit codes.
+    HeaderStatus ReadHeader()
+    {
+        unsigned char uchByte;
+        unsigned int  uiCodeLength;
+
+        if (m_bIsHeaderRead)
+            return HEADER_READ;
+
+        // Data written before the header existed
+        if (m_pszHeader.empty() && PeekByte(uchByte) && uchByte == 0)
+        {
+            m_uiVersion     = 0;
+            m_uiCodeLength  = LEGACY_CODE_LENGTH;
+            m_bIsHeaderRead = true;
+            return HEADER_READ;
+        }
+
+        while (m_pszHeader.size() < STREAM_HEADER_SIZE && GetByte(uchByte))
+        {
+            // Header opens with magic "LZW"
+            if (m_pszHeader.size() < 3 &&
+                uchByte != (unsigned char) STREAM_MAGIC[m_pszHeader.size()])
+                return HEADER_CORRUPT;
+
+            m_pszHeader.push_back((char) uchByte);
+        }
+
+        if (m_pszHeader.size() < STREAM_HEADER_SIZE)
+            return HEADER_PENDING;
+
+        m_uiVersion  = (unsigned char) m_pszHeader[3];
+        uiCodeLength = (unsigned char) m_pszHeader[4];
+        if (m_uiVersion < 1 || m_uiVersion > STREAM_VERSION ||
+            uiCodeLength < 8 || uiCodeLength > 16)
+            return HEADER_CORRUPT;
+
+        m_uiCodeLength  = uiCodeLength;
+        m_bIsHeaderRead = true;
+        return HEADER_READ;
+    }
+
+    // Supply next chunk of encrypted data
+    // Note: Chunk must stay valid until '>>' returns false
+    void Feed(const char *pchData, size_t uiSize)
+    {
+        m_pchData = pchData;
+        m_uiSize  = uiSize;
+    }
+
+    // Look at next byte of supplied data without consuming it
+    bool PeekByte(unsigned char &uchByte) const
+    {
+        if (m_uiSize == 0)
+            return false;
+
+        uchByte = (unsigned char) *m_pchData;
+        return true;
+    }
+
+    // Read next byte of supplied data (used for headers)
+    bool GetByte(unsigned char &uchByte)
+    {
+        if (!PeekByte(uchByte))
+            return false;
+
+        m_pchData++;
+        m_uiSize--;
+        return true;
+    }
+
+    // Skip padding up to the next byte boundary
+    void Align() { m_uiBitCount -= m_uiBitCount % 8; }
+
+    // Read up to N bytes following a byte boundary, appending them
+    // to a buffer. Bytes already fetched for codes are read first.
+    // Note: Returns number of bytes read
+    size_t ReadBytes(std::string &pszOut, size_t uiSize)
+    {
+        size_t uiRead = 0;
+
+        while (uiRead < uiSize && m_uiBitCount >= 8)
+        {
+            m_uiBitCount -= 8;
+            pszOut.push_back((char) ((m_u4Bits >> m_uiBitCount) & 0xff));
+            uiRead++;
+        }
+
+        if (uiSize - uiRead > m_uiSize)
+            uiSize = uiRead + m_uiSize;
+
+        pszOut.append(m_pchData, uiSize - uiRead);
+        m_pchData += uiSize - uiRead;
+        m_uiSize  -= uiSize - uiRead;
+
+        return uiSize;
+    }
+
+    // Check whether data ended within a code
+    // Note: Fewer than 8 zero bits are padding written by Flush()
+    bool HasPartialCode() const
+    {
+        return m_uiBitCount >= 8 ||
+               (m_u4Bits & ((1u << m_uiBitCount) - 1)) != 0;
+    }
+
     // Operator overloading for '>>'
     bool operator>>(uint16_t &u2Code)
     {
-        char ch;
-        
-        if (m_InStream.get(ch))
+        while (m_uiBitCount < m_uiCodeLength)
         {
-            u2Code = ch & 0xff;
-            
-            if (m_InStream.get(ch))
-            {
-                u2Code = (u2Code << 8) | (ch & 0xff);
-                return true;
-            }
+            if (m_uiSize == 0)
+                return false;
+
+            m_u4Bits      = (m_u4Bits << 8) | (*m_pchData++ & 0xff);
+            m_uiBitCount += 8;
+            m_uiSize--;
         }
-        
-        return false;
+
+        m_uiBitCount -= m_uiCodeLength;
+        u2Code = (uint16_t) ((m_u4Bits >> m_uiBitCount) &
+                             ((1u << m_uiCodeLength) - 1));
+
+        return true;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,182 @@
+/******************************************************************************//*!
+* @File          Matcher.h
+* 
+* @Title         Header file for LZW Matcher.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This header file defines the prototypes of classes and functions 
+*                for LZW Matcher, which searches a pattern in compressed data
+*                without decompressing it.
+* 
+*//*******************************************************************************/ 
+
+#pragma once
+
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <fstream>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "FileStream.h"
+
+
+/* Longest pattern Matcher searches for. Pattern automata take
+   O(length^2) bits, besides O(length) tables of 256 transitions. */
+const size_t MATCH_MAX_PATTERN_LENGTH = 1024;
+
+/* Marks a missing phrase or state of suffix automaton. */
+const int32_t MATCH_NONE = -1;
+
+
+/******************************************************************************
+* @Struct		Phrase
+*
+* @Description	Entry of Matcher's Map. Instead of the word itself, it keeps
+*               how the word relates to the pattern, so that a code is
+*               matched in constant time whatever the length of its word.
+******************************************************************************/
+struct Phrase
+{
+    int32_t       iPrefix;        // Code of word without its last symbol
+    uint32_t      uiLength;       // Length of word
+    uint32_t      uiState;        // Pattern prefix matched at end of word
+    int32_t       iFactor;        // State of word in suffix automaton
+    int32_t       iLastMatch;     // Longest prefix of word ending with pattern
+    int32_t       iLastSuffix;    // Longest prefix of word being a suffix
+                                  // of pattern
+    unsigned char uchFirst;       // First symbol of word
+    unsigned char uchSymbol;      // Last symbol of word
+};
+
+
+/******************************************************************************
+* @Class		Matcher
+*
+* @Description	Class representing LZW Matcher.
+* 				This class defines attributes and functionalities
+*               for searching a pattern in LZW compressed data.
+*               Matcher builds the same Map as Decoder, but never
+*               materialises words: every code is matched against
+*               the pattern through its Phrase, and occurrences are
+*               reported as offsets in the decompressed data.
+*               Matcher can be driven incrementally (Reset, Update, Finish)
+*               on memory buffers, or at once on streams and files.
+******************************************************************************/
+class Matcher
+{
+private:
+    std::string           m_pszPattern;
+    bool                  m_bIsPatternValid;
+    unsigned int          m_uiBitLength;
+    unsigned int          m_uiCodeLength;
+    unsigned int          m_uiMaxTableSize;
+    uint16_t              m_u2Code;
+    bool                  m_bIsOverflow;
+    bool                  m_bIsCorrupt;
+    bool                  m_bHasFlushCode;
+    bool                  m_bHasStoredCode;
+    bool                  m_bIsStoredBlock;
+    size_t                m_uiStoredSize;
+    std::string           m_pszStoredLength;
+    int32_t               m_iWord;
+    uint32_t              m_uiState;
+    uint64_t              m_u8Offset;
+    uint64_t              m_u8MatchCount;
+    std::vector<Phrase>   m_vPhrases;
+    std::vector<uint32_t> m_vuNextState;
+    std::vector<bool>     m_vbIsBorder;
+    std::vector<int32_t>  m_viNextFactor;
+    std::vector<bool>     m_vbIsSuffix;
+    std::string           m_pszSymbols;
+    DecryptStream         m_decin;
+
+    // Build automata recognising pattern
+    void InitialisePattern();
+
+    // Initialise a Map with ASCII characters
+    void InitialiseMap();
+
+    // Add ('word' of prefix code + symbol) into Map
+    void AddPhrase(uint16_t u2Code, int32_t iPrefix, unsigned char uchSymbol);
+
+    // Report occurrences of pattern ending within word of a code
+    void MatchPhrase(uint16_t u2Code, std::vector<uint64_t> &vu8Offsets);
+
+    // Read header and fix bit length of codes
+    bool ReadHeader();
+
+    // Search text of a stored block, which may be split across chunks
+    bool ReadStoredBlock(std::vector<uint64_t> &vu8Offsets);
+
+    // Disable copying
+    Matcher(const Matcher &);
+    Matcher &operator=(const Matcher &);
+
+public:
+    // Constructor
+    // Note: Bit length is read from header of compressed data;
+    //       the one given here only applies to data without header
+    Matcher(const std::string &pszPattern, unsigned int uiBitLength=16)
+    {
+        if (pszPattern.empty())
+            std::cerr << "Pattern should not be empty." << std::endl;
+        else if (pszPattern.size() > MATCH_MAX_PATTERN_LENGTH)
+            std::cerr << "Pattern should not be longer than "
+                      << MATCH_MAX_PATTERN_LENGTH << " bytes." << std::endl;
+
+        if (uiBitLength > 16)
+            std::cerr << "Bit Length should not be greater than 16."
+                      << std::endl;
+
+        m_pszPattern      = pszPattern;
+        m_bIsPatternValid = !pszPattern.empty() &&
+                            pszPattern.size() <= MATCH_MAX_PATTERN_LENGTH;
+        m_uiBitLength     = uiBitLength;
+
+        if (m_bIsPatternValid)
+            InitialisePattern();
+
+        Reset();
+    }
+
+    // Destructor
+    ~Matcher() {}
+
+    // Public getters
+    const std::string &GetPattern() { return m_pszPattern; }
+    unsigned int GetBitLength() { return m_uiBitLength; }
+
+    // Bit length of codes in current stream, 0 until header is read
+    unsigned int GetCodeLength() { return m_uiCodeLength; }
+
+    // Number of occurrences reported since Reset()
+    uint64_t GetMatchCount() { return m_u8MatchCount; }
+
+    // Start searching a new code stream with a fresh Map
+    void Reset();
+
+    // Search a chunk of encrypted data, appending offsets of occurrences
+    // in ascending order
+    bool Update(const char *pchData, size_t uiSize,
+                std::vector<uint64_t> &vu8Offsets);
+
+    // Check whether code stream ended on a code boundary
+    bool Finish();
+
+    // Search a compressed stream, writing offsets one per line
+    // Note: Occurrences are only counted when stream is NULL
+    bool Search(std::istream &CompressedStream, std::ostream *pOffsetStream);
+
+    // Search a compressed file, writing offsets to standard output
+    bool Search(std::string pszCompressedFile, bool bIsCountOnly=false);
+};
@@ -0,0 +1,128 @@
+/******************************************************************************//*!
+* @File          MultiEncoder.h
+* 
+* @Title         Header file for LZW MultiEncoder.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This header file defines the prototypes of classes and functions
+*                for LZW MultiEncoder, which encodes many independent texts
+*                in lockstep within one thread.
+* 
+*//*******************************************************************************/ 
+
+#pragma once
+
+#include <iostream>
+#include <string.h>
+#include <string>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+#include "Trie.h"
+#include "Encoder.h"
+
+
+/* Number of texts MultiEncoder advances in lockstep. Each lane keeps one
+   search of its Trie in flight, so more lanes hide more memory latency,
+   until their Tries crowd each other out of cache. Lockstep also costs
+   branch prediction, as words of different lanes end at unrelated
+   symbols; a single lane encodes texts one after another. Lockstep has
+   not yet been measured to beat a single lane, hence it is the default. */
+const unsigned int MULTI_DEFAULT_LANES = 1;
+const unsigned int MULTI_MAX_LANES     = 64;
+
+
+/******************************************************************************
+* @Struct		Lane
+*
+* @Description	Text being encoded by one Encoder of MultiEncoder.
+*               Text is split into blocks as Encoder::Update() would;
+*               symbols of a block are encoded one per round.
+******************************************************************************/
+struct Lane
+{
+    Encoder       *pEncoder;      // Encoder owning Trie of lane
+    const char    *pchText;       // Text being encoded, NULL if lane is idle
+    size_t        uiSize;         // Size of text
+    size_t        uiPos;          // Position of next symbol
+    size_t        uiBlockStart;   // Start of current block
+    size_t        uiBlockEnd;     // End of current block
+    bool          bIsBlock;       // Whether current block is encoded on trial
+    std::string   *pszCodes;      // Buffer codes are appended to
+};
+
+
+/******************************************************************************
+* @Class		MultiEncoder
+*
+* @Description	Class representing LZW MultiEncoder.
+* 				This class defines attributes and functionalities
+*               for encoding many independent texts with one thread.
+*               Every symbol depends on the Trie search of the one before,
+*               so a single text leaves the processor waiting for memory
+*               once its Trie outgrows cache. MultiEncoder advances one
+*               text per lane by a symbol each round, each with its own
+*               Encoder, and prefetches the node every lane searches next
+*               while it works on the others.
+*               Codes of every text are the same as Encoder outputs for
+*               the text supplied at once. Flexible parsing looks ahead
+*               beyond the current symbol, hence its texts are encoded
+*               one after another, as are texts given to a single lane.
+******************************************************************************/
+class MultiEncoder
+{
+private:
+    unsigned int        m_uiBitLength;
+    ParseMode           m_eParseMode;
+    std::vector<Lane>   m_vLanes;
+    const char *const   *m_apchTexts;
+    const size_t        *m_auiSizes;
+    std::string         *m_apszCodes;
+    size_t              m_uiTextCount;
+    size_t              m_uiNextText;
+    
+    // Start encoding the next text on a lane
+    bool StartText(Lane &lane);
+    
+    // Move a lane to its next block of symbols, finishing texts on the way
+    bool NextBlock(Lane &lane);
+    
+    // MultiEncoder owns its Encoders, hence it can not be copied
+    MultiEncoder(const MultiEncoder &);
+    MultiEncoder &operator=(const MultiEncoder &);
+    
+public:
+    // Constructor
+    // Note: Every lane holds an Encoder, reused from text to text
+    MultiEncoder(unsigned int uiBitLength=16,
+                 unsigned int uiLaneCount=MULTI_DEFAULT_LANES);
+    
+    // Destructor
+    ~MultiEncoder();
+    
+    // Public setters
+    // Note: New settings take effect from the next Encode()
+    void SetBitLength(unsigned int uiBitLength) { m_uiBitLength = uiBitLength; }
+    void SetParseMode(ParseMode eParseMode) { m_eParseMode = eParseMode; }
+    
+    // Public getters
+    unsigned int GetBitLength() { return m_uiBitLength; }
+    ParseMode GetParseMode() { return m_eParseMode; }
+    unsigned int GetLaneCount() { return (unsigned int) m_vLanes.size(); }
+    
+    // Encode independent texts, appending codes of each text
+    // to its own buffer
+    void Encode(size_t uiCount, const char *const *apchTexts,
+                const size_t *auiSizes, std::string *apszCodes);
+    
+    // Encode independent texts, appending codes of each text
+    // to its own buffer
+    void Encode(const std::vector<std::string> &vpszTexts,
+                std::vector<std::string> &vpszCodes);
+};
@@ -18,36 +18,100 @@
 
 #include <iostream>
 #include <string.h>
+#include <string>
 #include <vector>
+#include <algorithm>
+#include <new>
 #include <stdint.h>
 
 
+/* Hint that memory at an address will be read soon. */
+#if defined(__GNUC__)
+#define LZW_PREFETCH(pAddress) __builtin_prefetch(pAddress)
+#else
+#define LZW_PREFETCH(pAddress) ((void) (pAddress))
+#endif
+
+/* Children kept within a node. With 64 bit pointers, such a node
+   takes exactly one cache line of TRIE_CACHE_LINE bytes. */
+const size_t NODE_INLINE_CHILDREN = 5;
+
+/* Trie allocates its nodes in blocks of TRIE_BLOCK_NODES nodes, aligned to
+   TRIE_CACHE_LINE bytes, and reuses them after Clear(). */
+const size_t TRIE_BLOCK_NODES = 4096;
+const size_t TRIE_CACHE_LINE  = 64;
+
+
+class Node;
+
+
+/******************************************************************************
+* @Struct		ChildList
+*
+* @Description	Children of a Trie node beyond NODE_INLINE_CHILDREN.
+******************************************************************************/
+struct ChildList
+{
+    std::string        pszSymbols;     // Symbols of children, side by side
+    std::vector<Node*> vpChildren;     // Children, in the same order
+};
+
+
 /******************************************************************************
 * @Class		Node
 *
 * @Description	Class representing Trie Node.
 * 				This class defines attributes and functionalities
 *               of Trie Node.
+*               First NODE_INLINE_CHILDREN children are kept within the node
+*               together with their symbols, so that most nodes are searched
+*               without reading any other cache line; a node with more
+*               children keeps the rest in a ChildList.
 ******************************************************************************/
 class Node
 {
 private:
     char               m_chSymbol;
-    uint16_t           m_u2Code;
     bool               m_bIsWord;
-    std::vector<Node*> m_vpChildren;
+    uint16_t           m_u2Code;
+    uint16_t           m_u2ChildCount;
+    char               m_achChildSymbols[NODE_INLINE_CHILDREN];
+    Node               *m_apChildren[NODE_INLINE_CHILDREN];
+    ChildList          *m_pMoreChildren;
+    
+    // Node owns its ChildList, hence it can not be copied
+    Node(const Node &);
+    Node &operator=(const Node &);
 
 public:
     // Constructor
     Node(char chSymbol='\0', uint16_t u2Code=65535, bool bIsWord=false)
     {
-        m_chSymbol = chSymbol;
-        m_u2Code   = u2Code;
-        m_bIsWord  = bIsWord;
+        m_chSymbol      = chSymbol;
+        m_u2Code        = u2Code;
+        m_bIsWord       = bIsWord;
+        m_u2ChildCount  = 0;
+        m_pMoreChildren = NULL;
     }
 
     // Destructor
-    ~Node() {}
+    // Note: Nodes are owned by their Trie, not by their parent node
+    ~Node() { delete m_pMoreChildren; }
+    
+    // Reuse a released node, keeping memory of its ChildList
+    void Renew(char chSymbol, uint16_t u2Code, bool bIsWord)
+    {
+        m_chSymbol     = chSymbol;
+        m_u2Code       = u2Code;
+        m_bIsWord      = bIsWord;
+        m_u2ChildCount = 0;
+        
+        if (m_pMoreChildren != NULL)
+        {
+            m_pMoreChildren->pszSymbols.clear();
+            m_pMoreChildren->vpChildren.clear();
+        }
+    }
 
     // Public setter
     void SetSymbol(char chSymbol) { m_chSymbol = chSymbol; }
@@ -58,23 +122,96 @@ public:
     char const GetSymbol() { return m_chSymbol; }
     uint16_t const GetCode() { return m_u2Code; }
     bool const GetIsWord() { return m_bIsWord; }
-    std::vector<Node*> const GetChildren() { return m_vpChildren; }
+    std::vector<Node*> const GetChildren()
+    {
+        std::vector<Node*> vpChildren(m_apChildren, m_apChildren +
+                                      std::min((size_t) m_u2ChildCount,
+                                               NODE_INLINE_CHILDREN));
+        
+        if (m_pMoreChildren != NULL)
+            vpChildren.insert(vpChildren.end(),
+                              m_pMoreChildren->vpChildren.begin(),
+                              m_pMoreChildren->vpChildren.end());
+        
+        return vpChildren;
+    }
 
     // Check whether the current node is marked as a Word
     bool const IsWord() { return m_bIsWord; }
 
     // Add a child node
-    void AddChildNode(Node* pChild) { m_vpChildren.push_back(pChild); }
+    void AddChildNode(Node* pChild)
+    {
+        if (m_u2ChildCount < NODE_INLINE_CHILDREN)
+        {
+            m_achChildSymbols[m_u2ChildCount] = pChild->m_chSymbol;
+            m_apChildren[m_u2ChildCount]      = pChild;
+        }
+        else
+        {
+            if (m_pMoreChildren == NULL)
+                m_pMoreChildren = new ChildList;
+            
+            m_pMoreChildren->pszSymbols.push_back(pChild->m_chSymbol);
+            m_pMoreChildren->vpChildren.push_back(pChild);
+        }
+        
+        m_u2ChildCount++;
+    }
+    
+    // Remove the child node added last
+    // Note: Its memory is given back by Trie::ReleaseLastNode()
+    void RemoveLastChildNode()
+    {
+        m_u2ChildCount--;
+        
+        if (m_u2ChildCount >= NODE_INLINE_CHILDREN)
+        {
+            m_pMoreChildren->pszSymbols.erase(m_u2ChildCount -
+                                              NODE_INLINE_CHILDREN);
+            m_pMoreChildren->vpChildren.pop_back();
+        }
+    }
     
     // Search for a child node
     Node* SearchChildNode(char chSymbol)
     {
-        for (int i=0; i<m_vpChildren.size(); i++)
-            if (chSymbol == m_vpChildren[i]->m_chSymbol)
-                return m_vpChildren[i];
+        const char *pchSymbols;
+        size_t     uiCount = std::min((size_t) m_u2ChildCount,
+                                      NODE_INLINE_CHILDREN);
+        
+        for (size_t i=0; i<uiCount; i++)
+            if (chSymbol == m_achChildSymbols[i])
+                return m_apChildren[i];
+        
+        if (m_u2ChildCount <= NODE_INLINE_CHILDREN)
+            return NULL;
+        
+        pchSymbols = m_pMoreChildren->pszSymbols.data();
+        uiCount    = m_pMoreChildren->pszSymbols.size();
+        for (size_t i=0; i<uiCount; i++)
+            if (chSymbol == pchSymbols[i])
+                return m_pMoreChildren->vpChildren[i];
         
         return NULL;
     }
+    
+    // Hint that this node will be read soon
+    void Prefetch() const
+    {
+        LZW_PREFETCH(this);
+        LZW_PREFETCH((const char *) this + sizeof(Node) - 1);
+    }
+    
+    // Hint that children kept outside this node will be searched soon
+    void PrefetchChildren() const
+    {
+        if (m_u2ChildCount > NODE_INLINE_CHILDREN)
+        {
+            LZW_PREFETCH(m_pMoreChildren->pszSymbols.data());
+            LZW_PREFETCH(&m_pMoreChildren->vpChildren[0]);
+        }
+    }
 };
 
 
@@ -84,32 +221,53 @@ public:
 * @Description	Class representing Trie data structure.
 * 				This class defines attributes and functionalities
 *               of Trie data structure.
+*               Nodes are allocated one after another from blocks aligned
+*               to cache lines, so that a node takes a single cache line
+*               and nodes of a Trie stay close together. Clearing Trie
+*               hands the same nodes out again instead of releasing them.
 ******************************************************************************/
 class Trie
 {
 private:
-    Node        *m_pRoot;
+    Node               *m_pRoot;
+    std::vector<char*> m_vpchMemory;
+    std::vector<Node*> m_vpBlocks;
+    size_t             m_uiNodeCount;
+    size_t             m_uiConstructedCount;
     
-    static Trie *s_pTrie;
-
+    // Trie owns its nodes, hence it can not be copied
+    Trie(const Trie &);
+    Trie &operator=(const Trie &);
+    
+    // Add a block of nodes aligned to a cache line
+    void AddBlock();
+    
+public:
     // Constructor
     Trie()
     {
-        m_pRoot = new Node;
+        m_uiNodeCount        = 0;
+        m_uiConstructedCount = 0;
+        m_pRoot              = NewNode();
     }
     
     // Destructor
-    ~Trie() {}
+    ~Trie();
     
-public:
     // Get a Root Node of Trie data structure
     Node* const GetRootNode();
     
-    // Get an instance of singleton Trie class
-    static Trie *GetInstance();
+    // Remove all words from Trie data structure
+    void Clear();
+    
+    // Allocate a node of Trie data structure
+    Node* NewNode(char chSymbol='\0', uint16_t u2Code=65535, bool bIsWord=false);
+    
+    // Give back the node allocated last
+    void ReleaseLastNode() { m_uiNodeCount--; }
     
-    // Destroy an instance of singleton Trie class
-    static void DestroyInstance();
+    // Construct nodes in advance, up to a number of nodes in total
+    void Reserve(size_t uiNodeCount);
     
     // Store a word into Trie data structure
     void AddWord(Node *pNode, std::string pszWord, uint16_t u2Code);
@@ -0,0 +1,244 @@
+/******************************************************************************//*!
+* @File          lzw.h
+* 
+* @Title         C interface of LZW library.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This header file defines the stable C interface of `lzw`
+*                library, so that LZW compression can be used in-process
+*                without spawning `Encoder`/`Decoder` utilities.
+* 
+*                Two flavours are provided:
+*                1. One-shot calls, compressing/decompressing a memory
+*                   buffer into another memory buffer.
+*                2. Streaming context, consuming input in chunks of any size
+*                   and buffering output until it is read.
+*                Many independent buffers can also be compressed in one call,
+*                which interleaves their work to hide memory latency.
+*                Compressed data can also be searched for a pattern without
+*                decompressing it.
+* 
+*                Every function returning `int` returns LZW_OK on success
+*                or one of the negative LZW_ERROR_* status codes.
+* 
+*//*******************************************************************************/ 
+
+#ifndef LZW_H
+#define LZW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define LZW_API __attribute__((visibility("default")))
+#else
+#define LZW_API
+#endif
+
+
+/* Status codes */
+#define LZW_OK               0      /* Success */
+#define LZW_ERROR_PARAM     -1      /* Invalid argument */
+#define LZW_ERROR_BUFFER    -2      /* Output buffer too small */
+#define LZW_ERROR_DATA      -3      /* Corrupt or truncated compressed data */
+#define LZW_ERROR_MEMORY    -4      /* Out of memory */
+#define LZW_ERROR_STATE     -5      /* Call not valid in current state */
+
+/* Supported bit lengths of code */
+#define LZW_MIN_BIT_LENGTH   8
+#define LZW_MAX_BIT_LENGTH   16
+
+/* Bit length requesting the encoder to select one by trial compression
+   of the first MiB of input. Selected bit length is recorded in the
+   compressed data, so the decoder needs no bit length. */
+#define LZW_AUTO_BIT_LENGTH  0
+
+/* Compression flags */
+#define LZW_FLAG_FLEXIBLE    0x0001 /* Flexible parsing: slower encoding,
+                                       same decoding; output is smaller
+                                       only once dictionary is full */
+
+
+/* Most buffers lzw_compress_batch() advances in lockstep; 0 selects
+   the default of 1, i.e. one buffer after another */
+#define LZW_MAX_LANES        64
+
+/* Longest pattern accepted by lzw_search() */
+#define LZW_MAX_PATTERN_LENGTH 1024
+
+
+/* Direction of a streaming context */
+typedef enum
+{
+    LZW_COMPRESS   = 0,
+    LZW_DECOMPRESS = 1
+} lzw_mode;
+
+/* Opaque streaming context */
+typedef struct lzw_stream lzw_stream;
+
+/* Receives offset of an occurrence in decompressed data.
+   Returning non-zero stops the search. */
+typedef int (*lzw_match_callback)(void *opaque, uint64_t offset);
+
+
+/* Version string of library */
+LZW_API const char *lzw_version(void);
+
+/* Human readable description of a status code */
+LZW_API const char *lzw_strerror(int status);
+
+
+/*
+ * Upper bound of compressed size for `src_size` bytes of input.
+ * A compressing stream may exceed it by 5 bytes per lzw_stream_flush().
+ */
+LZW_API size_t lzw_compress_bound(size_t src_size);
+
+/*
+ * Compress `src_size` bytes from `src` into `dst`.
+ * On entry `*dst_size` holds capacity of `dst`, on return the size of
+ * compressed data. If `dst` is too small, LZW_ERROR_BUFFER is returned
+ * and `*dst_size` holds the required size.
+ */
+LZW_API int lzw_compress(const void *src, size_t src_size,
+                         void *dst, size_t *dst_size,
+                         unsigned int bit_length);
+
+/*
+ * Same as lzw_compress(), with a combination of LZW_FLAG_* flags.
+ */
+LZW_API int lzw_compress_ex(const void *src, size_t src_size,
+                            void *dst, size_t *dst_size,
+                            unsigned int bit_length, unsigned int flags);
+
+/*
+ * Compress `count` independent buffers: `src_size[i]` bytes from `src[i]`
+ * into `dst[i]`, exactly as lzw_compress_ex() compresses each of them.
+ * `dst_size[i]` is used as `*dst_size` in lzw_compress(); if some `dst[i]`
+ * is too small, the other buffers are still written and LZW_ERROR_BUFFER
+ * is returned.
+ * Up to `lanes` buffers are encoded in lockstep by the calling thread, each
+ * with its own dictionary, so that dictionary lookups of one buffer overlap
+ * with those of others instead of waiting for memory one after another.
+ * Whether this beats encoding them one after another (`lanes` = 1, also
+ * selected by 0) depends on how far dictionary lookups miss cache on the
+ * host; so far a single lane has been faster on every host measured.
+ * Greedy parsing only: with LZW_FLAG_FLEXIBLE, buffers are encoded one
+ * after another.
+ */
+LZW_API int lzw_compress_batch(size_t count,
+                               const void *const *src, const size_t *src_size,
+                               void *const *dst, size_t *dst_size,
+                               unsigned int bit_length, unsigned int flags,
+                               unsigned int lanes);
+
+/*
+ * Decompress `src_size` bytes from `src` into `dst`.
+ * `*dst_size` is used in the same way as in lzw_compress().
+ * Bit length is read from compressed data; `bit_length` only applies to
+ * data written without header by versions before 1.3 (0 means 16).
+ */
+LZW_API int lzw_decompress(const void *src, size_t src_size,
+                           void *dst, size_t *dst_size,
+                           unsigned int bit_length);
+
+
+/*
+ * Create a streaming context. Returns NULL on invalid arguments
+ * or when out of memory. `bit_length` is used as in lzw_compress() or
+ * lzw_decompress(), depending on `mode`.
+ */
+LZW_API lzw_stream *lzw_stream_create(lzw_mode mode, unsigned int bit_length);
+
+/*
+ * Same as lzw_stream_create(), with a combination of LZW_FLAG_* flags.
+ * Flags only affect compression.
+ */
+LZW_API lzw_stream *lzw_stream_create_ex(lzw_mode mode,
+                                         unsigned int bit_length,
+                                         unsigned int flags);
+
+/* Destroy a streaming context. NULL is ignored. */
+LZW_API void lzw_stream_destroy(lzw_stream *stream);
+
+/*
+ * Discard all state and pending output, so that the context can be reused
+ * for a new stream without reallocating it.
+ */
+LZW_API int lzw_stream_reset(lzw_stream *stream);
+
+/*
+ * Consume `src_size` bytes of input. Output produced is buffered inside
+ * the context until it is fetched with lzw_stream_read().
+ */
+LZW_API int lzw_stream_write(lzw_stream *stream,
+                             const void *src, size_t src_size);
+
+/*
+ * Sync flush: make all input written so far decodable from the output
+ * available now, padding it to a byte boundary. The dictionary is kept,
+ * so later input still benefits from earlier one; use it to frame
+ * messages that must be decoded as soon as they arrive.
+ * Input since the previous flush is stored as is when its codes would
+ * take more space, hence it teaches the dictionary nothing.
+ * Decompression delivers output as soon as codes arrive, hence flushing
+ * a decompressing context has no effect.
+ */
+LZW_API int lzw_stream_flush(lzw_stream *stream);
+
+/*
+ * Mark end of input. Remaining output becomes readable; for decompression
+ * LZW_ERROR_DATA is returned when the input was truncated.
+ * No further writes are accepted until lzw_stream_reset().
+ */
+LZW_API int lzw_stream_finish(lzw_stream *stream);
+
+/*
+ * Bit length of codes in current stream. Returns 0 while it is not yet
+ * known: until the header is read, or until enough input is sampled
+ * with LZW_AUTO_BIT_LENGTH.
+ */
+LZW_API unsigned int lzw_stream_bit_length(const lzw_stream *stream);
+
+/* Number of output bytes waiting to be read */
+LZW_API size_t lzw_stream_pending(const lzw_stream *stream);
+
+/*
+ * Copy up to `dst_size` pending output bytes into `dst`.
+ * Returns number of bytes copied.
+ */
+LZW_API size_t lzw_stream_read(lzw_stream *stream, void *dst, size_t dst_size);
+
+
+/*
+ * Search `src_size` bytes of compressed data from `src` for `pattern_size`
+ * bytes of `pattern`, without decompressing it. Offsets of all occurrences,
+ * overlapping ones included, are passed to `callback` in ascending order.
+ * If `match_count` is not NULL, it receives the number of occurrences
+ * reported. `callback` may be NULL to count occurrences only.
+ * Search runs in time proportional to the compressed size: a code is
+ * matched through its dictionary entry instead of its decompressed text.
+ * `bit_length` is used as in lzw_decompress().
+ */
+LZW_API int lzw_search(const void *src, size_t src_size,
+                       const void *pattern, size_t pattern_size,
+                       unsigned int bit_length,
+                       lzw_match_callback callback, void *opaque,
+                       uint64_t *match_count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZW_H */
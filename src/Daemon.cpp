@@ -0,0 +1,839 @@
+/******************************************************************************//*!
+* @File          Daemon.cpp
+* 
+* @Title         Implementation of LZW daemon.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      POSIX
+* 
+* @Description   This file implements member functions of Daemon class.
+*
+*//*******************************************************************************/ 
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+#include "Daemon.h"
+
+
+/* Helper */
+static void SetBlocking(int hSocket, bool bIsBlocking)
+{
+    int iFlags = fcntl(hSocket, F_GETFL, 0);
+    
+    if (bIsBlocking)
+        fcntl(hSocket, F_SETFL, iFlags & ~O_NONBLOCK);
+    else
+        fcntl(hSocket, F_SETFL, iFlags | O_NONBLOCK);
+}
+
+
+/* Helper */
+static bool IsStaleSocket(const struct sockaddr_un &Address)
+{
+    struct stat Status;
+    int         hSocket;
+    bool        bIsStale;
+    
+    // Only a socket nobody listens on is left behind by lzwd
+    if (stat(Address.sun_path, &Status) < 0 || !S_ISSOCK(Status.st_mode))
+        return false;
+    
+    hSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (hSocket < 0)
+        return false;
+    
+    bIsStale = connect(hSocket, (const struct sockaddr *) &Address,
+                       sizeof(Address)) < 0 && errno == ECONNREFUSED;
+    close(hSocket);
+    
+    return bIsStale;
+}
+
+
+/* Helper */
+static void CloseConnection(DaemonConnection *pConnection)
+{
+    close(pConnection->hSocket);
+    delete pConnection;
+}
+
+
+/* Helper */
+static void ReleaseBuffer(std::string &pszBuffer)
+{
+    if (pszBuffer.capacity() > DAEMON_BUFFER_STEP_SIZE)
+        std::string().swap(pszBuffer);
+    else
+        pszBuffer.clear();
+}
+
+
+/* Helper */
+static void StartResponse(DaemonConnection *pConnection, DaemonStatus eStatus,
+                          unsigned int uiCodeLength)
+{
+    FormatHeader(pConnection->achHeader, (unsigned char) eStatus, uiCodeLength,
+                 0, pConnection->pszResponse.size());
+    pConnection->uiDone     = 0;
+    pConnection->bIsSending = true;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Daemon
+*
+* @Description	Prepare lzwd; nothing is created until Start().
+*
+* @Input		string		pszSocketPath   Path of Unix domain socket
+*
+* @Input		unsigned int	uiWorkerCount   Number of worker threads
+******************************************************************************/
+Daemon::Daemon(std::string pszSocketPath, unsigned int uiWorkerCount)
+{
+    m_pszSocketPath    = pszSocketPath;
+    m_uiWorkerCount    = std::max(1u, uiWorkerCount);
+    m_hListenSocket    = -1;
+    m_ahWakePipe[0]    = -1;
+    m_ahWakePipe[1]    = -1;
+    m_bIsStopping      = false;
+    m_bIsStopRequested = 0;
+    
+    pthread_mutex_init(&m_hMutex, NULL);
+    pthread_cond_init(&m_hRequestReady, NULL);
+}
+
+
+/******************************************************************************
+* @Function		Daemon::~Daemon
+*
+* @Description	Stop workers, close all connections and remove socket.
+******************************************************************************/
+Daemon::~Daemon()
+{
+    pthread_mutex_lock(&m_hMutex);
+    m_bIsStopping = true;
+    pthread_cond_broadcast(&m_hRequestReady);
+    pthread_mutex_unlock(&m_hMutex);
+    
+    for (size_t i=0; i<m_vpWorkers.size(); i++)
+    {
+        pthread_join(m_vpWorkers[i]->hThread, NULL);
+        delete m_vpWorkers[i]->pEncoder;
+        delete m_vpWorkers[i]->pDecoder;
+        delete m_vpWorkers[i];
+    }
+    
+    for (size_t i=0; i<m_vpConnections.size(); i++)
+        CloseConnection(m_vpConnections[i]);
+    for (size_t i=0; i<m_qpRequests.size(); i++)
+        CloseConnection(m_qpRequests[i]);
+    for (size_t i=0; i<m_vpServed.size(); i++)
+        CloseConnection(m_vpServed[i]);
+    
+    if (m_hListenSocket >= 0)
+    {
+        close(m_hListenSocket);
+        unlink(m_pszSocketPath.c_str());
+    }
+    
+    if (m_ahWakePipe[0] >= 0)
+    {
+        close(m_ahWakePipe[0]);
+        close(m_ahWakePipe[1]);
+    }
+    
+    pthread_cond_destroy(&m_hRequestReady);
+    pthread_mutex_destroy(&m_hMutex);
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Listen
+*
+* @Description	Create Unix domain socket, accessible by the user only, and
+*               listen on it. A socket left behind by an lzwd no longer
+*               running is replaced; a live one is not.
+*
+* @Return		bool                        Returns true on success
+******************************************************************************/
+bool Daemon::Listen()
+{
+    struct sockaddr_un Address;
+    mode_t             hMask;
+    int                iResult;
+    bool               bIsInUse;
+    
+    if (m_pszSocketPath.size() >= sizeof(Address.sun_path))
+    {
+        std::cerr << "Socket path \'" << m_pszSocketPath << "\' is too long."
+                  << std::endl;
+        return false;
+    }
+    
+    memset(&Address, 0, sizeof(Address));
+    Address.sun_family = AF_UNIX;
+    memcpy(Address.sun_path, m_pszSocketPath.data(), m_pszSocketPath.size());
+    
+    m_hListenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_hListenSocket < 0)
+    {
+        std::cerr << "Unable to create socket." << std::endl;
+        return false;
+    }
+    
+    hMask    = umask(0077);
+    iResult  = bind(m_hListenSocket, (struct sockaddr *) &Address,
+                    sizeof(Address));
+    bIsInUse = (iResult < 0 && errno == EADDRINUSE);
+    if (bIsInUse && IsStaleSocket(Address))
+    {
+        unlink(m_pszSocketPath.c_str());
+        iResult  = bind(m_hListenSocket, (struct sockaddr *) &Address,
+                        sizeof(Address));
+        bIsInUse = false;
+    }
+    umask(hMask);
+    
+    if (iResult < 0 || listen(m_hListenSocket, SOMAXCONN) < 0)
+    {
+        std::cerr << "Unable to listen on \'" << m_pszSocketPath << "\'"
+                  << (bIsInUse ? "; it is in use." : ".") << std::endl;
+        close(m_hListenSocket);
+        m_hListenSocket = -1;
+        return false;
+    }
+    
+    SetBlocking(m_hListenSocket, false);
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Start
+*
+* @Description	Listen on socket and start worker threads. Every worker
+*               gets an Encoder whose Trie is preallocated for 16 bit codes,
+*               so that no request allocates or initialises a dictionary
+*               from scratch.
+*
+* @Return		bool                        Returns true on success
+******************************************************************************/
+bool Daemon::Start()
+{
+    DaemonWorker *pWorker;
+    
+    if (pipe(m_ahWakePipe) < 0)
+    {
+        std::cerr << "Unable to create pipe." << std::endl;
+        m_ahWakePipe[0] = -1;
+        return false;
+    }
+    SetBlocking(m_ahWakePipe[0], false);
+    SetBlocking(m_ahWakePipe[1], false);
+    
+    if (!Listen())
+        return false;
+    
+    for (unsigned int i=0; i<m_uiWorkerCount; i++)
+    {
+        pWorker           = new DaemonWorker;
+        pWorker->pDaemon  = this;
+        pWorker->pEncoder = new Encoder(AUTO_MAX_BIT_LENGTH);
+        pWorker->pDecoder = new Decoder(LEGACY_CODE_LENGTH);
+        pWorker->pEncoder->Reserve();
+    
+        if (pthread_create(&pWorker->hThread, NULL, RunWorker, pWorker) != 0)
+        {
+            std::cerr << "Unable to start worker thread." << std::endl;
+            delete pWorker->pEncoder;
+            delete pWorker->pDecoder;
+            delete pWorker;
+            return false;
+        }
+    
+        m_vpWorkers.push_back(pWorker);
+    }
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Stop
+*
+* @Description	Ask Run() to return. Only an async-signal-safe flag and
+*               write() are used, hence it may be called from a signal
+*               handler.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Daemon::Stop()
+{
+    char chWake = 0;
+    
+    m_bIsStopRequested = 1;
+    if (m_ahWakePipe[1] >= 0)
+        (void) !write(m_ahWakePipe[1], &chWake, 1);
+}
+
+
+/******************************************************************************
+* @Function		Daemon::AcceptConnections
+*
+* @Description	Accept all pending connections and watch them for requests.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Daemon::AcceptConnections()
+{
+    DaemonConnection *pConnection;
+    int              hSocket;
+    
+    while ((hSocket = accept(m_hListenSocket, NULL, NULL)) >= 0)
+    {
+        // Messages are received and sent as far as the socket allows
+        SetBlocking(hSocket, false);
+#ifdef SO_NOSIGPIPE
+        int iEnable = 1;
+        setsockopt(hSocket, SOL_SOCKET, SO_NOSIGPIPE, &iEnable, sizeof(iEnable));
+#endif
+    
+        pConnection              = new DaemonConnection;
+        pConnection->hSocket       = hSocket;
+        pConnection->uiDone        = 0;
+        pConnection->uiPayloadSize = 0;
+        pConnection->bIsSending    = false;
+        pConnection->bIsClosing    = false;
+        pConnection->tLastActive   = time(NULL);
+    
+        m_vpConnections.push_back(pConnection);
+    }
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Run
+*
+* @Description	Serve requests until Stop() is called. Socket, wake pipe
+*               and connections are polled together. Requests and
+*               responses are received and sent as far as sockets allow;
+*               requests completed in one poll are queued as a batch and
+*               workers are woken once for all of them. A connection
+*               stalled within a message for DAEMON_IO_TIMEOUT_SECONDS
+*               is closed.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Daemon::Run()
+{
+    std::vector<struct pollfd>      vPollFds;
+    std::vector<DaemonConnection*>  vpWatched;
+    std::vector<DaemonConnection*>  vpRequests;
+    std::vector<DaemonConnection*>  vpServed;
+    DaemonConnection                *pConnection;
+    struct pollfd                   PollFd;
+    char                            achDrain[64];
+    bool                            bIsStallPossible;
+    bool                            bIsKept;
+    time_t                          tNow;
+    
+    PollFd.revents = 0;
+    
+    while (!m_bIsStopRequested)
+    {
+        vPollFds.clear();
+        PollFd.events = POLLIN;
+        PollFd.fd     = m_ahWakePipe[0];
+        vPollFds.push_back(PollFd);
+        PollFd.fd     = m_hListenSocket;
+        vPollFds.push_back(PollFd);
+    
+        bIsStallPossible = false;
+        for (size_t i=0; i<m_vpConnections.size(); i++)
+        {
+            pConnection   = m_vpConnections[i];
+            PollFd.fd     = pConnection->hSocket;
+            PollFd.events = pConnection->bIsSending ? POLLOUT : POLLIN;
+            vPollFds.push_back(PollFd);
+    
+            if (pConnection->bIsSending || pConnection->uiDone > 0)
+                bIsStallPossible = true;
+        }
+    
+        // Connections within a message are checked for stalls every second
+        if (poll(&vPollFds[0], vPollFds.size(),
+                 bIsStallPossible ? 1000 : -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+    
+            std::cerr << "Unable to poll connections." << std::endl;
+            break;
+        }
+    
+        // Receive requests and send responses; keep watching connections
+        // until their request is complete
+        tNow = time(NULL);
+        vpWatched.clear();
+        vpRequests.clear();
+        for (size_t i=0; i<m_vpConnections.size(); i++)
+        {
+            pConnection = m_vpConnections[i];
+            bIsKept     = true;
+            if (vPollFds[i+2].revents != 0)
+                bIsKept = pConnection->bIsSending ? SendResponse(pConnection) :
+                                                    ReceiveRequest(pConnection);
+            else if (pConnection->bIsSending || pConnection->uiDone > 0)
+                bIsKept = (tNow - pConnection->tLastActive <
+                           (time_t) DAEMON_IO_TIMEOUT_SECONDS);
+    
+            if (!bIsKept)
+                CloseConnection(pConnection);
+            else if (!pConnection->bIsSending &&
+                     pConnection->uiDone >= DAEMON_HEADER_SIZE &&
+                     pConnection->uiDone - DAEMON_HEADER_SIZE ==
+                     pConnection->uiPayloadSize)
+                vpRequests.push_back(pConnection);
+            else
+                vpWatched.push_back(pConnection);
+        }
+    
+        // Send responses of connections served by workers
+        if (vPollFds[0].revents != 0)
+        {
+            while (read(m_ahWakePipe[0], achDrain, sizeof(achDrain)) > 0)
+                ;
+    
+            pthread_mutex_lock(&m_hMutex);
+            vpServed.swap(m_vpServed);
+            pthread_mutex_unlock(&m_hMutex);
+    
+            for (size_t i=0; i<vpServed.size(); i++)
+            {
+                if (SendResponse(vpServed[i]))
+                    vpWatched.push_back(vpServed[i]);
+                else
+                    CloseConnection(vpServed[i]);
+            }
+            vpServed.clear();
+        }
+    
+        if (!vpRequests.empty())
+        {
+            pthread_mutex_lock(&m_hMutex);
+            m_qpRequests.insert(m_qpRequests.end(), vpRequests.begin(),
+                                vpRequests.end());
+            pthread_cond_broadcast(&m_hRequestReady);
+            pthread_mutex_unlock(&m_hMutex);
+        }
+    
+        m_vpConnections.swap(vpWatched);
+    
+        if (vPollFds[1].revents != 0)
+            AcceptConnections();
+    }
+}
+
+
+/******************************************************************************
+* @Function		Daemon::ReceiveRequest
+*
+* @Description	Receive as much of a request as the socket allows, without
+*               blocking. Reception stops once the request is complete,
+*               leaving any next request in the socket. Payload buffer
+*               grows by DAEMON_BUFFER_STEP_SIZE as bytes arrive. A request
+*               too large to accept, or to buffer, is answered with an
+*               error, after which the connection is closed.
+*
+* @Input		DaemonConnection*	pConnection     Connection receiving
+*
+* @Return		bool                        Returns false if connection
+*                                           is to be closed
+******************************************************************************/
+bool Daemon::ReceiveRequest(DaemonConnection *pConnection)
+{
+    char    *pchData;
+    size_t  uiSize;
+    size_t  uiReceived;
+    ssize_t iReceived;
+    
+    while (true)
+    {
+        if (pConnection->uiDone < DAEMON_HEADER_SIZE)
+        {
+            pchData = pConnection->achHeader + pConnection->uiDone;
+            uiSize  = DAEMON_HEADER_SIZE - pConnection->uiDone;
+        }
+        else
+        {
+            uiReceived = pConnection->uiDone - DAEMON_HEADER_SIZE;
+    
+            // Request is complete
+            if (uiReceived == pConnection->uiPayloadSize)
+                return true;
+    
+            if (uiReceived == pConnection->pszPayload.size())
+            {
+                try
+                {
+                    pConnection->pszPayload.resize(
+                        std::min(pConnection->uiPayloadSize,
+                                 uiReceived + DAEMON_BUFFER_STEP_SIZE));
+                }
+                catch (const std::bad_alloc &)
+                {
+                    std::string().swap(pConnection->pszPayload);
+                    pConnection->pszResponse = "Out of memory.";
+                    pConnection->bIsClosing  = true;
+                    StartResponse(pConnection, DAEMON_ERROR, 0);
+                    return SendResponse(pConnection);
+                }
+            }
+    
+            pchData = &pConnection->pszPayload[0] + uiReceived;
+            uiSize  = pConnection->pszPayload.size() - uiReceived;
+        }
+    
+        iReceived = recv(pConnection->hSocket, pchData, uiSize, 0);
+        if (iReceived < 0 && errno == EINTR)
+            continue;
+        if (iReceived < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (iReceived <= 0)
+            return false;
+    
+        pConnection->uiDone      += (size_t) iReceived;
+        pConnection->tLastActive  = time(NULL);
+    
+        if (pConnection->uiDone == DAEMON_HEADER_SIZE)
+        {
+            if (!ParseHeader(pConnection->achHeader, pConnection->uchOperation,
+                             pConnection->uiBitLength, pConnection->uiFlags,
+                             pConnection->uiPayloadSize))
+                return false;
+    
+            if (pConnection->uiPayloadSize > DAEMON_MAX_PAYLOAD_SIZE)
+            {
+                pConnection->pszResponse = "Request is too large.";
+                pConnection->bIsClosing  = true;
+                StartResponse(pConnection, DAEMON_ERROR, 0);
+                return SendResponse(pConnection);
+            }
+        }
+    }
+}
+
+
+/******************************************************************************
+* @Function		Daemon::SendResponse
+*
+* @Description	Send as much of a response as the socket allows, without
+*               blocking. Once the response is sent, the connection
+*               waits for its next request.
+*
+* @Input		DaemonConnection*	pConnection     Connection sending
+*
+* @Return		bool                        Returns false if connection
+*                                           is to be closed
+******************************************************************************/
+bool Daemon::SendResponse(DaemonConnection *pConnection)
+{
+    const char *pchData;
+    size_t     uiSize;
+    ssize_t    iSent;
+    
+    while (true)
+    {
+        if (pConnection->uiDone < DAEMON_HEADER_SIZE)
+        {
+            pchData = pConnection->achHeader + pConnection->uiDone;
+            uiSize  = DAEMON_HEADER_SIZE - pConnection->uiDone;
+        }
+        else
+        {
+            pchData = pConnection->pszResponse.data() +
+                      (pConnection->uiDone - DAEMON_HEADER_SIZE);
+            uiSize  = pConnection->pszResponse.size() -
+                      (pConnection->uiDone - DAEMON_HEADER_SIZE);
+        }
+    
+        // Response is sent
+        if (uiSize == 0)
+            break;
+    
+        iSent = send(pConnection->hSocket, pchData, uiSize, DAEMON_SEND_FLAGS);
+        if (iSent < 0 && errno == EINTR)
+            continue;
+        if (iSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return true;
+        if (iSent <= 0)
+            return false;
+    
+        pConnection->uiDone      += (size_t) iSent;
+        pConnection->tLastActive  = time(NULL);
+    }
+    
+    if (pConnection->bIsClosing)
+        return false;
+    
+    // Small buffer is kept for a worker to code the next response into
+    ReleaseBuffer(pConnection->pszResponse);
+    pConnection->uiDone        = 0;
+    pConnection->uiPayloadSize = 0;
+    pConnection->bIsSending    = false;
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::NextRequest
+*
+* @Description	Take next connection with a complete request, waiting for
+*               one.
+*
+* @Return		DaemonConnection*           Returns connection,
+*                                           or NULL once lzwd stops
+******************************************************************************/
+DaemonConnection* Daemon::NextRequest()
+{
+    DaemonConnection *pConnection = NULL;
+    
+    pthread_mutex_lock(&m_hMutex);
+    while (m_qpRequests.empty() && !m_bIsStopping)
+        pthread_cond_wait(&m_hRequestReady, &m_hMutex);
+    
+    if (!m_bIsStopping)
+    {
+        pConnection = m_qpRequests.front();
+        m_qpRequests.pop_front();
+    }
+    pthread_mutex_unlock(&m_hMutex);
+    
+    return pConnection;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::ReturnConnection
+*
+* @Description	Hand a served connection back to Run() to send its
+*               response and watch it for its next request.
+*
+* @Input		DaemonConnection*	pConnection     Served connection
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Daemon::ReturnConnection(DaemonConnection *pConnection)
+{
+    char chWake = 0;
+    
+    pthread_mutex_lock(&m_hMutex);
+    m_vpServed.push_back(pConnection);
+    pthread_mutex_unlock(&m_hMutex);
+    
+    (void) !write(m_ahWakePipe[1], &chWake, 1);
+}
+
+
+/******************************************************************************
+* @Function		Daemon::RunWorker
+*
+* @Description	Serve complete requests until lzwd stops.
+*
+* @Input		void*		pArgument       DaemonWorker of thread
+*
+* @Return		void*                       Returns NULL
+******************************************************************************/
+void* Daemon::RunWorker(void *pArgument)
+{
+    DaemonWorker     *pWorker = (DaemonWorker *) pArgument;
+    Daemon           *pDaemon = pWorker->pDaemon;
+    DaemonConnection *pConnection;
+    
+    while ((pConnection = pDaemon->NextRequest()) != NULL)
+    {
+        pDaemon->Serve(pWorker, pConnection);
+        pDaemon->ReturnConnection(pConnection);
+    }
+    
+    return NULL;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Serve
+*
+* @Description	Code payload of a complete request into its response.
+*               Encoder or Decoder used is reset right away, while Run()
+*               sends the response, so that releasing the old dictionary
+*               and initialising a fresh one are not paid by the next
+*               request.
+*
+* @Input		DaemonWorker*	pWorker         Worker serving request
+*
+* @Input		DaemonConnection*	pConnection     Connection of request
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Daemon::Serve(DaemonWorker *pWorker, DaemonConnection *pConnection)
+{
+    unsigned char uchOperation = pConnection->uchOperation;
+    unsigned int  uiCodeLength = 0;
+    DaemonStatus  eStatus;
+    
+    pWorker->pszOutput.clear();
+    try
+    {
+        if (uchOperation == DAEMON_COMPRESS)
+            eStatus = Compress(pWorker, pConnection->pszPayload,
+                               pConnection->uiBitLength, pConnection->uiFlags,
+                               uiCodeLength);
+        else if (uchOperation == DAEMON_DECOMPRESS)
+            eStatus = Decompress(pWorker, pConnection->pszPayload,
+                                 pConnection->uiBitLength);
+        else
+        {
+            pWorker->pszOutput = "Unknown operation.";
+            eStatus = DAEMON_ERROR;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        pWorker->pszOutput = "Out of memory.";
+        eStatus = DAEMON_ERROR;
+    }
+    
+    // Response takes the output, leaving its empty buffer to the worker
+    pConnection->pszResponse.swap(pWorker->pszOutput);
+    ReleaseBuffer(pConnection->pszPayload);
+    StartResponse(pConnection, eStatus, uiCodeLength);
+    
+    // Prepare dictionary for the next request
+    if (uchOperation == DAEMON_COMPRESS)
+        pWorker->pEncoder->Reset();
+    else if (uchOperation == DAEMON_DECOMPRESS)
+        pWorker->pDecoder->Reset();
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Compress
+*
+* @Description	Compress payload of a request. Encoder of worker is reset
+*               beforehand only if the request changes its settings.
+*
+* @Input		DaemonWorker*	pWorker         Worker serving request
+*
+* @Input		string&		pszInput        Payload of request
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes, or
+*                                           AUTO_BIT_LENGTH
+*
+* @Input		unsigned int	uiFlags         DAEMON_FLAG_* flags
+*
+* @Output		unsigned int&	uiCodeLength    Bit length of codes used
+*
+* @Return		DaemonStatus                Returns status of response
+******************************************************************************/
+DaemonStatus Daemon::Compress(DaemonWorker *pWorker, const std::string &pszInput,
+                              unsigned int uiBitLength, unsigned int uiFlags,
+                              unsigned int &uiCodeLength)
+{
+    Encoder   *pEncoder   = pWorker->pEncoder;
+    ParseMode eParseMode  = PARSE_GREEDY;
+    
+    if (!Encoder::IsValidBitLength(uiBitLength) ||
+        (uiFlags & ~DAEMON_FLAG_FLEXIBLE) != 0)
+    {
+        pWorker->pszOutput = "Invalid bit length or flags.";
+        return DAEMON_ERROR;
+    }
+    
+    if (uiFlags & DAEMON_FLAG_FLEXIBLE)
+        eParseMode = PARSE_FLEXIBLE;
+    
+    if (pEncoder->GetBitLength() != uiBitLength ||
+        pEncoder->GetParseMode() != eParseMode)
+    {
+        pEncoder->SetBitLength(uiBitLength);
+        pEncoder->SetParseMode(eParseMode);
+        pEncoder->Reset();
+    }
+    
+    pEncoder->Update(pszInput.data(), pszInput.size(), pWorker->pszOutput);
+    pEncoder->Finish(pWorker->pszOutput);
+    uiCodeLength = pEncoder->GetCodeLength();
+    
+    return DAEMON_OK;
+}
+
+
+/******************************************************************************
+* @Function		Daemon::Decompress
+*
+* @Description	Decompress payload of a request chunk by chunk, refusing
+*               text larger than DAEMON_MAX_PAYLOAD_SIZE.
+*
+* @Input		DaemonWorker*	pWorker         Worker serving request
+*
+* @Input		string&		pszInput        Payload of request
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes for data
+*                                           without header
+*
+* @Return		DaemonStatus                Returns status of response
+******************************************************************************/
+DaemonStatus Daemon::Decompress(DaemonWorker *pWorker,
+                                const std::string &pszInput,
+                                unsigned int uiBitLength)
+{
+    Decoder     *pDecoder = pWorker->pDecoder;
+    const char  *pchCodes = pszInput.data();
+    size_t      uiSize    = pszInput.size();
+    size_t      uiChunk;
+    
+    if (uiBitLength == 0 || uiBitLength > LEGACY_CODE_LENGTH)
+        uiBitLength = LEGACY_CODE_LENGTH;
+    
+    if (pDecoder->GetBitLength() != uiBitLength)
+    {
+        pDecoder->SetBitLength(uiBitLength);
+        pDecoder->Reset();
+    }
+    
+    for (size_t i=0; i<uiSize; i+=uiChunk)
+    {
+        uiChunk = std::min(uiSize - i, DAEMON_DECODE_CHUNK_SIZE);
+        if (!pDecoder->Update(pchCodes + i, uiChunk, pWorker->pszOutput))
+        {
+            pWorker->pszOutput = "Compressed data is corrupt.";
+            return DAEMON_ERROR;
+        }
+    
+        if (pWorker->pszOutput.size() > DAEMON_MAX_PAYLOAD_SIZE)
+        {
+            pWorker->pszOutput = "Decompressed data is too large.";
+            return DAEMON_ERROR;
+        }
+    }
+    
+    if (!pDecoder->Finish())
+    {
+        pWorker->pszOutput = "Compressed data is truncated.";
+        return DAEMON_ERROR;
+    }
+    
+    return DAEMON_OK;
+}
@@ -0,0 +1,533 @@
+/******************************************************************************//*!
+* @File          DaemonClient.cpp
+* 
+* @Title         Implementation of LZW daemon client.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      POSIX
+* 
+* @Description   This file implements messages exchanged with `lzwd` and
+*                member functions of DaemonClient class.
+*
+*//*******************************************************************************/ 
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sstream>
+
+#include "Daemon.h"
+
+
+/* Helper */
+static bool SendBytes(int hSocket, const char *pchData, size_t uiSize)
+{
+    ssize_t iSent;
+    
+    while (uiSize > 0)
+    {
+        iSent = send(hSocket, pchData, uiSize, DAEMON_SEND_FLAGS);
+        if (iSent < 0 && errno == EINTR)
+            continue;
+        if (iSent <= 0)
+            return false;
+    
+        pchData += iSent;
+        uiSize  -= (size_t) iSent;
+    }
+    
+    return true;
+}
+
+
+/* Helper */
+static bool ReadFile(std::string pszFile, std::string &pszData)
+{
+    std::ifstream      hFile;
+    std::ostringstream Buffer;
+    
+    hFile.open(pszFile.c_str(), std::ios::binary);
+    if (!hFile.is_open())
+    {
+        std::cerr << "Unable to open \'" << pszFile << "\'." << std::endl;
+        return false;
+    }
+    
+    Buffer << hFile.rdbuf();
+    pszData = Buffer.str();
+    
+    return !hFile.bad();
+}
+
+
+/* Helper */
+static bool WriteFile(std::string pszFile, const std::string &pszData)
+{
+    std::ofstream hFile;
+    
+    hFile.open(pszFile.c_str(), std::ios::binary | std::ios::out);
+    if (!hFile.is_open())
+    {
+        std::cerr << "Unable to create \'" << pszFile << "\'." << std::endl;
+        return false;
+    }
+    
+    hFile.write(pszData.data(), pszData.size());
+    hFile.close();
+    
+    return !hFile.fail();
+}
+
+
+/******************************************************************************
+* @Function		DaemonSocketPath
+*
+* @Description	Get socket path of lzwd: value of DAEMON_SOCKET_ENV if set,
+*               otherwise a path in /tmp private to the user.
+*
+* @Return		string                      Returns socket path
+******************************************************************************/
+std::string DaemonSocketPath()
+{
+    const char         *pszPath = getenv(DAEMON_SOCKET_ENV);
+    std::ostringstream Path;
+    
+    if (pszPath != NULL && *pszPath != '\0')
+        return pszPath;
+    
+    Path << "/tmp/lzwd-" << getuid() << ".sock";
+    return Path.str();
+}
+
+
+/******************************************************************************
+* @Function		FormatHeader
+*
+* @Description	Format header of a message.
+*
+* @Output		char*		pchHeader       Buffer of DAEMON_HEADER_SIZE bytes
+*
+* @Input		unsigned char	uchType         Operation or status
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes
+*
+* @Input		unsigned int	uiFlags         DAEMON_FLAG_* flags
+*
+* @Input		size_t		uiSize          Size of payload
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void FormatHeader(char *pchHeader, unsigned char uchType,
+                  unsigned int uiBitLength, unsigned int uiFlags, size_t uiSize)
+{
+    memcpy(pchHeader, DAEMON_MAGIC, 4);
+    pchHeader[4] = (char) uchType;
+    pchHeader[5] = (char) uiBitLength;
+    pchHeader[6] = (char) uiFlags;
+    pchHeader[7] = 0;
+    for (int i=0; i<8; i++)
+        pchHeader[8+i] = (char) ((uint64_t) uiSize >> (56 - 8*i));
+}
+
+
+/******************************************************************************
+* @Function		ParseHeader
+*
+* @Description	Parse header of a message.
+*               Size of payload is left to the receiver to limit.
+*
+* @Input		const char*	pchHeader       Header of DAEMON_HEADER_SIZE bytes
+*
+* @Output		unsigned char&	uchType         Operation or status
+*
+* @Output		unsigned int&	uiBitLength     Bit length of codes
+*
+* @Output		unsigned int&	uiFlags         DAEMON_FLAG_* flags
+*
+* @Output		size_t&		uiSize          Size of payload
+*
+* @Return		bool                        Returns false if header
+*                                           is not valid
+******************************************************************************/
+bool ParseHeader(const char *pchHeader, unsigned char &uchType,
+                 unsigned int &uiBitLength, unsigned int &uiFlags,
+                 size_t &uiSize)
+{
+    uint64_t u8Size = 0;
+    
+    if (memcmp(pchHeader, DAEMON_MAGIC, 4) != 0 || pchHeader[7] != 0)
+        return false;
+    
+    for (int i=0; i<8; i++)
+        u8Size = (u8Size << 8) | (unsigned char) pchHeader[8+i];
+    if (u8Size > (uint64_t) (size_t) -1)
+        return false;
+    
+    uchType     = (unsigned char) pchHeader[4];
+    uiBitLength = (unsigned char) pchHeader[5];
+    uiFlags     = (unsigned char) pchHeader[6];
+    uiSize      = (size_t) u8Size;
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		SendMessage
+*
+* @Description	Send a header followed by payload to a socket.
+*
+* @Input		int			hSocket         Connected socket
+*
+* @Input		unsigned char	uchType         Operation or status
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes
+*
+* @Input		unsigned int	uiFlags         DAEMON_FLAG_* flags
+*
+* @Input		const char*	pchPayload      Payload
+*
+* @Input		size_t		uiSize          Size of payload
+*
+* @Return		bool                        Returns false if connection
+*                                           is broken
+******************************************************************************/
+bool SendMessage(int hSocket, unsigned char uchType, unsigned int uiBitLength,
+                 unsigned int uiFlags, const char *pchPayload, size_t uiSize)
+{
+    char achHeader[DAEMON_HEADER_SIZE];
+    
+    FormatHeader(achHeader, uchType, uiBitLength, uiFlags, uiSize);
+    
+    return SendBytes(hSocket, achHeader, DAEMON_HEADER_SIZE) &&
+           SendBytes(hSocket, pchPayload, uiSize);
+}
+
+
+/******************************************************************************
+* @Function		ReceiveHeader
+*
+* @Description	Receive header of a message from a socket.
+*               Size of payload is left to the receiver to limit.
+*
+* @Input		int			hSocket         Connected socket
+*
+* @Output		unsigned char&	uchType         Operation or status
+*
+* @Output		unsigned int&	uiBitLength     Bit length of codes
+*
+* @Output		unsigned int&	uiFlags         DAEMON_FLAG_* flags
+*
+* @Output		size_t&		uiSize          Size of payload
+*
+* @Return		bool                        Returns false if connection
+*                                           is closed or broken, or header
+*                                           is not valid
+******************************************************************************/
+bool ReceiveHeader(int hSocket, unsigned char &uchType,
+                   unsigned int &uiBitLength, unsigned int &uiFlags,
+                   size_t &uiSize)
+{
+    char achHeader[DAEMON_HEADER_SIZE];
+    
+    return ReceiveBytes(hSocket, achHeader, DAEMON_HEADER_SIZE) &&
+           ParseHeader(achHeader, uchType, uiBitLength, uiFlags, uiSize);
+}
+
+
+/******************************************************************************
+* @Function		ReceiveBytes
+*
+* @Description	Receive exactly the given number of bytes from a socket.
+*
+* @Input		int			hSocket         Connected socket
+*
+* @Output		char*		pchData         Buffer for bytes
+*
+* @Input		size_t		uiSize          Number of bytes
+*
+* @Return		bool                        Returns false if connection
+*                                           is closed or broken first
+******************************************************************************/
+bool ReceiveBytes(int hSocket, char *pchData, size_t uiSize)
+{
+    ssize_t iReceived;
+    
+    while (uiSize > 0)
+    {
+        iReceived = recv(hSocket, pchData, uiSize, 0);
+        if (iReceived < 0 && errno == EINTR)
+            continue;
+        if (iReceived <= 0)
+            return false;
+    
+        pchData += iReceived;
+        uiSize  -= (size_t) iReceived;
+    }
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Connect
+*
+* @Description	Connect to lzwd, unless connected already.
+*
+* @Return		bool                        Returns false if lzwd
+*                                           is not running
+******************************************************************************/
+bool DaemonClient::Connect()
+{
+    struct sockaddr_un Address;
+    
+    if (m_hSocket >= 0)
+        return true;
+    
+    if (m_pszSocketPath.size() >= sizeof(Address.sun_path))
+        return false;
+    
+    memset(&Address, 0, sizeof(Address));
+    Address.sun_family = AF_UNIX;
+    memcpy(Address.sun_path, m_pszSocketPath.data(), m_pszSocketPath.size());
+    
+    m_hSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_hSocket < 0)
+        return false;
+    
+#ifdef SO_NOSIGPIPE
+    int iEnable = 1;
+    setsockopt(m_hSocket, SOL_SOCKET, SO_NOSIGPIPE, &iEnable, sizeof(iEnable));
+#endif
+    
+    if (connect(m_hSocket, (struct sockaddr *) &Address, sizeof(Address)) < 0)
+    {
+        Close();
+        return false;
+    }
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Close
+*
+* @Description	Disconnect from lzwd.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void DaemonClient::Close()
+{
+    if (m_hSocket >= 0)
+        close(m_hSocket);
+    m_hSocket = -1;
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Request
+*
+* @Description	Send a request to lzwd and receive its response.
+*               A connection lost before the response arrives means
+*               lzwd is unavailable; the request is not retried.
+*
+* @Input		DaemonOperation	eOperation      Operation requested
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes
+*
+* @Input		unsigned int	uiFlags         DAEMON_FLAG_* flags
+*
+* @Input		string&		pszInput        Payload of request
+*
+* @Output		string&		pszOutput       Payload of response
+*
+* @Output		unsigned int&	uiCodeLength    Bit length in response
+*
+* @Return		DaemonStatus                Returns status of response
+******************************************************************************/
+DaemonStatus DaemonClient::Request(DaemonOperation eOperation,
+                                   unsigned int uiBitLength,
+                                   unsigned int uiFlags,
+                                   const std::string &pszInput,
+                                   std::string &pszOutput,
+                                   unsigned int &uiCodeLength)
+{
+    unsigned char uchStatus;
+    unsigned int  uiResponseFlags;
+    size_t        uiSize;
+    
+    if (pszInput.size() > DAEMON_MAX_PAYLOAD_SIZE || !Connect())
+        return DAEMON_UNAVAILABLE;
+    
+    if (!SendMessage(m_hSocket, (unsigned char) eOperation, uiBitLength,
+                     uiFlags, pszInput.data(), pszInput.size()) ||
+        !ReceiveHeader(m_hSocket, uchStatus, uiCodeLength, uiResponseFlags,
+                       uiSize))
+    {
+        Close();
+        return DAEMON_UNAVAILABLE;
+    }
+    
+    pszOutput.resize(uiSize);
+    if (uiSize > 0 && !ReceiveBytes(m_hSocket, &pszOutput[0], uiSize))
+    {
+        Close();
+        return DAEMON_UNAVAILABLE;
+    }
+    
+    if (uchStatus != DAEMON_OK)
+    {
+        std::cerr << "lzwd: " << pszOutput << std::endl;
+        return DAEMON_ERROR;
+    }
+    
+    return DAEMON_OK;
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Compress
+*
+* @Description	Compress a memory buffer by lzwd.
+*
+* @Input		string&		pszText         Text to be compressed
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes, or
+*                                           AUTO_BIT_LENGTH
+*
+* @Input		ParseMode	eParseMode      Parse mode of Encoder
+*
+* @Output		string&		pszCodes        Compressed data
+*
+* @Output		unsigned int&	uiCodeLength    Bit length of codes used
+*
+* @Return		DaemonStatus                Returns status of response
+******************************************************************************/
+DaemonStatus DaemonClient::Compress(const std::string &pszText,
+                                    unsigned int uiBitLength,
+                                    ParseMode eParseMode,
+                                    std::string &pszCodes,
+                                    unsigned int &uiCodeLength)
+{
+    unsigned int uiFlags = 0;
+    
+    if (eParseMode == PARSE_FLEXIBLE)
+        uiFlags |= DAEMON_FLAG_FLEXIBLE;
+    
+    return Request(DAEMON_COMPRESS, uiBitLength, uiFlags, pszText, pszCodes,
+                   uiCodeLength);
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Decompress
+*
+* @Description	Decompress a memory buffer by lzwd.
+*
+* @Input		string&		pszCodes        Compressed data
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes for data
+*                                           without header
+*
+* @Output		string&		pszText         Decompressed text
+*
+* @Return		DaemonStatus                Returns status of response
+******************************************************************************/
+DaemonStatus DaemonClient::Decompress(const std::string &pszCodes,
+                                      unsigned int uiBitLength,
+                                      std::string &pszText)
+{
+    unsigned int uiCodeLength;
+    
+    return Request(DAEMON_DECOMPRESS, uiBitLength, 0, pszCodes, pszText,
+                   uiCodeLength);
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Encode
+*
+* @Description	Compress a file by lzwd. Compressed file is named
+*               as by Encoder::Encode(), and is not created unless
+*               lzwd serves the request.
+*
+* @Input		string		pszTextFile     Text file to be compressed
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes, or
+*                                           AUTO_BIT_LENGTH
+*
+* @Input		ParseMode	eParseMode      Parse mode of Encoder
+*
+* @Output		unsigned int&	uiCodeLength    Bit length of codes used
+*
+* @Return		DaemonStatus                Returns status of request;
+*                                           DAEMON_ERROR also if files
+*                                           can not be accessed
+******************************************************************************/
+DaemonStatus DaemonClient::Encode(std::string pszTextFile,
+                                  unsigned int uiBitLength,
+                                  ParseMode eParseMode,
+                                  unsigned int &uiCodeLength)
+{
+    DaemonStatus eStatus;
+    std::string  pszText;
+    std::string  pszCodes;
+    
+    if (!ReadFile(pszTextFile, pszText))
+        return DAEMON_ERROR;
+    
+    eStatus = Compress(pszText, uiBitLength, eParseMode, pszCodes,
+                       uiCodeLength);
+    if (eStatus != DAEMON_OK)
+        return eStatus;
+    
+    if (!WriteFile(pszTextFile.substr(0, pszTextFile.rfind(".")) + ".lzw",
+                   pszCodes))
+        return DAEMON_ERROR;
+    
+    return DAEMON_OK;
+}
+
+
+/******************************************************************************
+* @Function		DaemonClient::Decode
+*
+* @Description	Decompress a file by lzwd. Decompressed file is named
+*               as by Decoder::Decode(), and is not created unless
+*               lzwd serves the request.
+*
+* @Input		string		pszCompressedFile     Compressed file
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes for file
+*                                           without header
+*
+* @Return		DaemonStatus                Returns status of request;
+*                                           DAEMON_ERROR also if files
+*                                           can not be accessed
+******************************************************************************/
+DaemonStatus DaemonClient::Decode(std::string pszCompressedFile,
+                                  unsigned int uiBitLength)
+{
+    DaemonStatus eStatus;
+    std::string  pszCodes;
+    std::string  pszText;
+    
+    if (!ReadFile(pszCompressedFile, pszCodes))
+        return DAEMON_ERROR;
+    
+    eStatus = Decompress(pszCodes, uiBitLength, pszText);
+    if (eStatus != DAEMON_OK)
+        return eStatus;
+    
+    if (!WriteFile(pszCompressedFile.substr(0, pszCompressedFile.rfind("."))
+                   + "_decoded.txt", pszText))
+        return DAEMON_ERROR;
+    
+    return DAEMON_OK;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************//*!
+* @File          DaemonMain.cpp
+* 
+* @Title         Command line utility for LZW daemon.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      POSIX
+* 
+* @Description   This file implements `lzwd`, a long-running service
+*                compressing and decompressing data for `Encoder` and
+*                `Decoder` utilities over a Unix domain socket.
+*
+*//*******************************************************************************/ 
+
+#include <unistd.h>
+
+#include "Daemon.h"
+
+
+/* Daemon stopped by signal handler */
+static Daemon *g_pDaemon = NULL;
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName
+    << " [--socket <Socket Path>] [--workers <Count>]\n"
+    << "\tSocket Path\t\t Unix domain socket to listen on (default: $"
+    << DAEMON_SOCKET_ENV << ",\n"
+    << "\t\t\t\t or /tmp/lzwd-<uid>.sock).\n"
+    << "\tCount\t\t\t Number of worker threads (default: number of CPUs).\n"
+    << "Runs in foreground until interrupted. Utilities hand their work over\n"
+    << "to lzwd when " << DAEMON_SOCKET_ENV << " is set, or with `--daemon`."
+    << std::endl;
+}
+
+
+/* Helper */
+static void HandleSignal(int iSignal)
+{
+    (void) iSignal;
+    if (g_pDaemon != NULL)
+        g_pDaemon->Stop();
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    std::string  pszSocketPath = DaemonSocketPath();
+    long         lCpuCount     = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int uiWorkerCount = lCpuCount > 0 ? (unsigned int) lCpuCount : 1;
+    std::string  pszOption;
+    
+    // Parse commandline arguments
+    for (int i=1; i<argc; i+=2)
+    {
+        pszOption = argv[i];
+        if (i+1 == argc || (pszOption != "--socket" && pszOption != "--workers"))
+        {
+            ShowUsage(argv[0]);
+            return -1;
+        }
+    
+        if (pszOption == "--socket")
+            pszSocketPath = argv[i+1];
+        else
+            uiWorkerCount = atoi(argv[i+1]);
+    }
+    
+    if (uiWorkerCount < 1)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    
+    // Create 'Daemon' instance
+    Daemon *daemon = new Daemon(pszSocketPath, uiWorkerCount);
+    
+    // Stop cleanly on interrupt; a client going away is not an error
+    g_pDaemon = daemon;
+    signal(SIGINT, HandleSignal);
+    signal(SIGTERM, HandleSignal);
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Start serving
+    if (!daemon->Start())
+    {
+        delete daemon;
+        return -1;
+    }
+    std::cout << __FUNCTION__
+              << "(): lzwd listening on \'"
+              << daemon->GetSocketPath()
+              << "\' with "
+              << daemon->GetWorkerCount()
+              << " workers.."
+              << std::endl;
+    
+    daemon->Run();
+    
+    g_pDaemon = NULL;
+    delete daemon;
+    std::cout << __FUNCTION__
+              << "(): lzwd stopped!"
+              << std::endl;
+    
+    return 0;
+}
@@ -16,142 +16,376 @@
 #include "Decoder.h"
 
 
-/* Initializing LZW Decoder's static data member. */
-uint16_t Decoder::s_u2Code = 0;
-
-
 /******************************************************************************
 * @Function		Decoder::InitialiseMap
 *
 * @Description	Initialise a Map with ASCII characters.
+*               Words of single characters are the same in every stream,
+*               so they are added once; words learnt from the last stream
+*               are left in place, as codes beyond the next one are never
+*               looked up, and are overwritten as codes are assigned.
 *
-* @Input		map<uint16_t, string> &		CodeWordMap     Map of Code -> Word
-*
-* @Return		void                                        Returns nothing
+* @Return		void                        Returns nothing
 ******************************************************************************/
-void Decoder::InitialiseMap(std::map<uint16_t, std::string> &CodeWordMap)
+void Decoder::InitialiseMap()
 {
-    for(s_u2Code=0; s_u2Code<=255; s_u2Code++)
-        CodeWordMap[s_u2Code] = std::string(1, (char) s_u2Code);
+    if (m_vCodeWords.empty())
+    {
+        m_vCodeWords.resize(256);
+        for (unsigned int i=0; i<=255; i++)
+        {
+            m_vCodeWords[i].u2Prefix  = 0;
+            m_vCodeWords[i].uiLength  = 1;
+            m_vCodeWords[i].uchFirst  = (unsigned char) i;
+            m_vCodeWords[i].uchSymbol = (unsigned char) i;
+        }
+    }
+    
+    m_u2Code = 256;
 }
 
 
 /******************************************************************************
-* @Function		Decoder::Decode
+* @Function		Decoder::WriteWord
 *
-* @Description	Decode a compressed file using LZW decompression algorithm.
+* @Description	Append word of a code to text, spelling it from its last
+*               symbol back to the first.
 *
-* @Input		string		pszCompressedFile     Compressed file
-*                                                 to be decompressed
+* @Input		uint16_t	u2Code          Code of word
+*
+* @Input		string&		pszText         Buffer to append word to
 *
 * @Return		void                        Returns nothing
 ******************************************************************************/
-void Decoder::Decode(std::string pszCompressedFile)
+void Decoder::WriteWord(uint16_t u2Code, std::string &pszText)
 {
-    bool                            bIsOverflow = false;
-    uint16_t                        u2Code;
-    std::string                     pszWord = "";
-    std::string                     pszNewWord = "";
-    char                            *pszTextFile = new char[250];
-    std::ifstream                   hCompressedFile;
-    std::ofstream                   hTextFile;
-    std::map<uint16_t, std::string> CodeWordMap;
+    const CodeWord *pWord   = &m_vCodeWords[u2Code];
+    size_t         uiStart  = pszText.size();
+    char           *pchText;
     
-    // Construct a name of decompressed file
-    pszCompressedFile.copy(pszTextFile, pszCompressedFile.rfind("."));
-    strcat(pszTextFile, "_decoded.txt");
+    pszText.resize(uiStart + pWord->uiLength);
+    pchText = &pszText[uiStart];
     
-    // Open a compressed file for reading encrypted data and
-    // a decompressed file for writing text data
-    hCompressedFile.open(pszCompressedFile.c_str(), std::ios_base::binary);
-    hTextFile.open(pszTextFile, std::ios::out);
+    for (uint32_t i=pWord->uiLength; i>0; i--)
+    {
+        pchText[i-1] = (char) pWord->uchSymbol;
+        pWord        = &m_vCodeWords[pWord->u2Prefix];
+    }
+}
+
+
+/******************************************************************************
+* @Function		Decoder::Reset
+*
+* @Description	Start decoding a new code stream with a fresh Map.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Decoder::Reset()
+{
+    InitialiseMap();
+    
+    m_uiCodeLength  = 0;
+    m_bIsOverflow   = false;
+    m_bIsCorrupt    = false;
+    m_bHasFlushCode  = false;
+    m_bHasStoredCode = false;
+    m_bIsStoredBlock = false;
+    m_uiStoredSize   = 0;
+    m_pszStoredLength.clear();
+    m_iWord          = DECODE_NONE;
+    m_decin.Reset(LEGACY_CODE_LENGTH);
+}
+
+
+/******************************************************************************
+* @Function		Decoder::ReadHeader
+*
+* @Description	Read header of compressed data and fix bit length of codes.
+*               Header may be split across chunks. Data starting with a
+*               zero byte has no header; it holds 16 bit codes and
+*               bit length given to Decoder limits the Map.
+*
+* @Return		bool                        Returns true once bit length
+*                                           of codes is known
+******************************************************************************/
+bool Decoder::ReadHeader()
+{
+    switch (m_decin.ReadHeader())
+    {
+        case HEADER_PENDING:
+            return false;
     
-    // Create a DecryptStream using which encrypted data can be read
-    DecryptStream decin(hCompressedFile);
+        case HEADER_CORRUPT:
+            m_bIsCorrupt = true;
+            return false;
     
-    // Initialise Map with ASCII characters
-    InitialiseMap(CodeWordMap);
+        default:
+            break;
+    }
     
-    // Read first code from compressed file and output corresponding word
-    decin >> u2Code;
-    pszWord = CodeWordMap[u2Code];
-    hTextFile << pszWord;
+    m_uiCodeLength = m_decin.GetCodeLength();
+    if (m_decin.GetVersion() == 0)
+        m_uiMaxTableSize = (unsigned int) pow(2.0, m_uiBitLength);
+    else
+        m_uiMaxTableSize = (unsigned int) pow(2.0, m_uiCodeLength);
     
-    // Fetch encrypted data two bytes at a time from a compressed file,
-    // till the EOF is reached
-    while (decin >> u2Code)
+    // Codes longer than 8 bits reserve FLUSH_CODE from version 2
+    // and STORED_CODE from version 3
+    m_bHasFlushCode  = m_decin.HasFlushCode();
+    m_bHasStoredCode = m_decin.HasStoredCode();
+    m_u2Code         = m_decin.GetFirstWordCode();
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Decoder::ReadStoredBlock
+*
+* @Description	Copy text of a stored block straight to the output.
+*               Length and text of the block may be split across chunks.
+*
+* @Input		string&		pszText         Buffer to append text to
+*
+* @Return		bool                        Returns true once the whole
+*                                           block is copied
+******************************************************************************/
+bool Decoder::ReadStoredBlock(std::string &pszText)
+{
+    if (m_pszStoredLength.size() < STORED_LENGTH_SIZE)
+    {
+        m_decin.ReadBytes(m_pszStoredLength,
+                          STORED_LENGTH_SIZE - m_pszStoredLength.size());
+        if (m_pszStoredLength.size() < STORED_LENGTH_SIZE)
+            return false;
+    
+        m_uiStoredSize = ((unsigned char) m_pszStoredLength[0] << 8) |
+                         (unsigned char) m_pszStoredLength[1];
+    }
+    
+    m_uiStoredSize -= m_decin.ReadBytes(pszText, m_uiStoredSize);
+    if (m_uiStoredSize > 0)
+        return false;
+    
+    m_bIsStoredBlock = false;
+    m_pszStoredLength.clear();
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Decoder::Update
+*
+* @Description	Decode a chunk of encrypted data using LZW decompression
+*               algorithm. Encrypted data may be supplied in chunks
+*               of any size.
+*
+* @Input		const char*	pchData         Encrypted data to be decompressed
+*
+* @Input		size_t		uiSize          Size of encrypted data
+*
+* @Input		string&		pszText         Buffer to append text to
+*
+* @Return		bool                        Returns false on corrupt data
+******************************************************************************/
+bool Decoder::Update(const char *pchData, size_t uiSize, std::string &pszText)
+{
+    uint16_t      u2Code;
+    unsigned char uchFirst;
+    
+    if (m_bIsCorrupt)
+        return false;
+    
+    m_decin.Feed(pchData, uiSize);
+    
+    if (m_uiCodeLength == 0 && !ReadHeader())
+        return !m_bIsCorrupt;
+    
+    // Fetch encrypted data one code at a time from a chunk,
+    // till the chunk is consumed
+    while (true)
     {
-        // If code does not exist in Map,
-        // then create a new word
-        // by appending first character of 'word' to 'word'.
-        // else fetch word corresponding to code from Map.
-        if (CodeWordMap[u2Code].empty())
-            pszNewWord = pszWord + pszWord[0];
+        if (m_bIsStoredBlock && !ReadStoredBlock(pszText))
+            break;
+    
+        if (!(m_decin >> u2Code))
+            break;
+    
+        // Skip padding after a sync flush point;
+        // Map and 'word' are kept for the codes that follow
+        if (u2Code == FLUSH_CODE && m_bHasFlushCode)
+        {
+            m_decin.Align();
+            continue;
+        }
+    
+        // Text stored as is follows padding; Map is kept,
+        // but the next code starts a new 'word'
+        if (u2Code == STORED_CODE && m_bHasStoredCode)
+        {
+            m_decin.Align();
+            m_bIsStoredBlock = true;
+            m_iWord          = DECODE_NONE;
+            continue;
+        }
+    
+        // Fetch first character of new word from Map.
+        // Note: Only the code being added next may be missing,
+        //       its word being ('word' + first character of 'word').
+        if (u2Code < m_u2Code || (m_bIsOverflow && u2Code == m_u2Code))
+        {
+            uchFirst = m_vCodeWords[u2Code].uchFirst;
+        }
+        else if (m_iWord != DECODE_NONE && u2Code == m_u2Code &&
+                 m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
+        {
+            uchFirst = m_vCodeWords[m_iWord].uchFirst;
+        }
         else
-            pszNewWord = CodeWordMap[u2Code];
-        
-        // Output word
-        hTextFile << pszNewWord;
-        
+        {
+            m_bIsCorrupt = true;
+            return false;
+        }
+    
         // Add ('word' + first character of new word) into Map,
-        // if Map is not full
-        if (s_u2Code < m_uiMaxTableSize && !bIsOverflow)
+        // if Map is not full and this is not the first code
+        if (m_iWord != DECODE_NONE && m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
         {
-            CodeWordMap[s_u2Code] = pszWord + pszNewWord[0];
-            if (s_u2Code != (m_uiMaxTableSize-1))
-                s_u2Code++;
+            // Map grows as codes are assigned, and keeps its size
+            // for the streams that follow
+            if (m_u2Code >= m_vCodeWords.size())
+                m_vCodeWords.resize(std::min((size_t) m_uiMaxTableSize,
+                                             2 * (size_t) m_u2Code));
+    
+            CodeWord &NewWord = m_vCodeWords[m_u2Code];
+    
+            NewWord.u2Prefix  = (uint16_t) m_iWord;
+            NewWord.uiLength  = m_vCodeWords[m_iWord].uiLength + 1;
+            NewWord.uchFirst  = m_vCodeWords[m_iWord].uchFirst;
+            NewWord.uchSymbol = uchFirst;
+    
+            if (m_u2Code != (m_uiMaxTableSize-1))
+                m_u2Code++;
             else
-                bIsOverflow = true;
+                m_bIsOverflow = true;
         }
-        
+    
+        // Output word
+        WriteWord(u2Code, pszText);
+    
         // Update 'word' with a new word
-        pszWord = pszNewWord;
+        m_iWord = u2Code;
     }
     
-    // Close files
-    hCompressedFile.close();
-    hTextFile.close();
+    return true;
 }
 
 
-/* Helper */
-void ShowUsage(std::string pszExecutableName)
+/******************************************************************************
+* @Function		Decoder::Finish
+*
+* @Description	Check whether code stream ended on a code boundary.
+*               Empty data is a valid empty stream; a partial header is not.
+*
+* @Return		bool                        Returns false on truncated data
+******************************************************************************/
+bool Decoder::Finish()
 {
-    std::cerr << "Usage: " << pszExecutableName << " <File Path> <Bit Length>\n"
-    << "\tFile Path\t\t Path of encrypted file to be decompressed.\n"
-    << "\tBit Length\t\t N-bit representation of code."
-    << std::endl;
+    if (m_uiCodeLength == 0 && m_decin.HasPartialHeader())
+        return false;
+    
+    return !m_bIsCorrupt && !m_bIsStoredBlock && !m_decin.HasPartialCode();
 }
 
 
-/* Entry point */
-int main(int argc, const char *argv[])
+/******************************************************************************
+* @Function		Decoder::Decode
+*
+* @Description	Decode a compressed stream using LZW decompression algorithm.
+*
+* @Input		istream&	CompressedStream    Encrypted data to be decompressed
+*
+* @Input		ostream&	TextStream          Stream to write text to
+*
+* @Return		bool                            Returns true on success
+******************************************************************************/
+bool Decoder::Decode(std::istream &CompressedStream, std::ostream &TextStream)
 {
-    std::string  pszCompressedFile;
-    unsigned int uiBitLength;
+    std::string pszCodes(STREAM_CHUNK_SIZE, '\0');
+    std::string pszText;
     
-    // Parse commandline arguments
-    if (argc != 3)
+    Reset();
+    
+    // Fetch encrypted data chunk by chunk from a compressed stream,
+    // till the EOF is reached
+    while (CompressedStream.read(&pszCodes[0], pszCodes.size()) ||
+           CompressedStream.gcount() > 0)
     {
-        ShowUsage(argv[0]);
-        return -1;
+        if (!Update(pszCodes.data(), (size_t) CompressedStream.gcount(),
+                    pszText))
+        {
+            std::cerr << "Compressed data is corrupt." << std::endl;
+            return false;
+        }
+    
+        TextStream.write(pszText.data(), pszText.size());
+        pszText.clear();
     }
     
-    pszCompressedFile = argv[1];
-    uiBitLength       = atoi(argv[2]);
+    if (!Finish())
+    {
+        std::cerr << "Compressed data is truncated." << std::endl;
+        return false;
+    }
     
-    // Create 'Decoder' instance
-    Decoder *dec = new Decoder(uiBitLength);
+    return !CompressedStream.bad() && TextStream.good();
+}
+
+
+/******************************************************************************
+* @Function		Decoder::Decode
+*
+* @Description	Decode a compressed file using LZW decompression algorithm.
+*
+* @Input		string		pszCompressedFile     Compressed file
+*                                                 to be decompressed
+*
+* @Return		bool                        Returns true on success
+******************************************************************************/
+bool Decoder::Decode(std::string pszCompressedFile)
+{
+    bool          bIsDecoded;
+    std::string   pszTextFile;
+    std::ifstream hCompressedFile;
+    std::ofstream hTextFile;
     
-    // Start decoding
-    std::cout << __FUNCTION__
-              << "(): Decrypting \'"
-              << pszCompressedFile
-              << "\'.." << std::endl;
-    dec->Decode(pszCompressedFile);
-    std::cout << __FUNCTION__
-              << "(): Decrypting finished!"
-              << std::endl;
+    // Construct a name of decompressed file
+    pszTextFile = pszCompressedFile.substr(0, pszCompressedFile.rfind("."))
+                + "_decoded.txt";
+    
+    // Open a compressed file for reading encrypted data and
+    // a decompressed file for writing text data
+    hCompressedFile.open(pszCompressedFile.c_str(), std::ios_base::binary);
+    if (!hCompressedFile.is_open())
+    {
+        std::cerr << "Unable to open \'" << pszCompressedFile << "\'."
+                  << std::endl;
+        return false;
+    }
+    
+    hTextFile.open(pszTextFile.c_str(), std::ios::binary | std::ios::out);
+    if (!hTextFile.is_open())
+    {
+        std::cerr << "Unable to create \'" << pszTextFile << "\'." << std::endl;
+        return false;
+    }
+    
+    bIsDecoded = Decode(hCompressedFile, hTextFile);
+    
+    // Close files
+    hCompressedFile.close();
+    hTextFile.close();
     
-    return 0;
+    return bIsDecoded;
 }
@@ -0,0 +1,102 @@
+/******************************************************************************//*!
+* @File          DecoderMain.cpp
+* 
+* @Title         Command line utility for LZW Decoder.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements `Decoder` utility, a thin wrapper
+*                around LZW library.
+*
+*//*******************************************************************************/ 
+
+#include "Encoder.h"
+#include "Decoder.h"
+#include "Daemon.h"
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName
+    << " <File Path> [Bit Length] [--daemon]\n"
+    << "\tFile Path\t\t Path of encrypted file to be decompressed.\n"
+    << "\tBit Length\t\t N-bit representation of code (8 to 16); only\n"
+    << "\t\t\t\t needed for files written without header\n"
+    << "\t\t\t\t (default 16).\n"
+    << "\t--daemon\t\t Let `lzwd` decode the file; implied when\n"
+    << "\t\t\t\t " << DAEMON_SOCKET_ENV << " is set. Decodes locally"
+    << " if lzwd is not running."
+    << std::endl;
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    std::string  pszCompressedFile;
+    unsigned int uiBitLength = 16;
+    const char   *pszSocket  = getenv(DAEMON_SOCKET_ENV);
+    bool         bUseDaemon  = pszSocket != NULL && *pszSocket != '\0';
+    DaemonStatus eStatus;
+    
+    // Parse commandline arguments
+    if (argc > 2 && std::string(argv[argc-1]) == "--daemon")
+    {
+        bUseDaemon = true;
+        argc--;
+    }
+    
+    if (argc != 2 && argc != 3)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    
+    pszCompressedFile = argv[1];
+    if (argc == 3 && (!Encoder::ParseBitLength(argv[2], uiBitLength) ||
+                      uiBitLength == AUTO_BIT_LENGTH))
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    
+    // Start decoding
+    std::cout << __FUNCTION__
+              << "(): Decrypting \'"
+              << pszCompressedFile
+              << "\'.." << std::endl;
+    
+    // Hand file over to 'lzwd', if it is running
+    eStatus = DAEMON_UNAVAILABLE;
+    if (bUseDaemon)
+    {
+        DaemonClient client;
+        
+        eStatus = client.Decode(pszCompressedFile, uiBitLength);
+        if (eStatus == DAEMON_ERROR)
+            return -1;
+        if (eStatus == DAEMON_UNAVAILABLE)
+            std::cerr << "lzwd is not available at \'"
+                      << client.GetSocketPath()
+                      << "\'; decoding locally." << std::endl;
+    }
+    
+    // Otherwise create 'Decoder' instance
+    if (eStatus == DAEMON_UNAVAILABLE)
+    {
+        Decoder *dec = new Decoder(uiBitLength);
+        
+        if (!dec->Decode(pszCompressedFile))
+            return -1;
+    }
+    std::cout << __FUNCTION__
+              << "(): Decrypting finished!"
+              << std::endl;
+    
+    return 0;
+}
@@ -16,14 +16,79 @@
 #include "Encoder.h"
 
 
-/* Initializing LZW Encoder's static data member. */
-uint16_t Encoder::s_u2Code = 0;
+/* Automatic selection prefers a shorter bit length, whose smaller Trie is
+   faster to search, while its trial output is within this percentage of
+   the smallest trial output. */
+static const size_t AUTO_TOLERANCE_PERCENT = 1;
+
+/* Blocks whose bytes carry more entropy than this many bits per byte, like
+   already compressed or encrypted data, are stored as is without trial
+   encoding, which would cost as much time as compressing them. */
+static const double STORED_ENTROPY_BITS = 7.5;
+
+
+/* Helper */
+static double ByteEntropy(const char *pchText, size_t uiSize)
+{
+    size_t auiCount[256] = {0};
+    double dEntropy      = 0.0;
+    double dProbability;
+    
+    for (size_t i=0; i<uiSize; i++)
+        auiCount[(unsigned char) pchText[i]]++;
+    
+    for (size_t i=0; i<256; i++)
+    {
+        if (auiCount[i] == 0)
+            continue;
+        
+        dProbability = (double) auiCount[i] / uiSize;
+        dEntropy    -= dProbability * log(dProbability) / log(2.0);
+    }
+    
+    return dEntropy;
+}
+
+
+/******************************************************************************
+* @Function		Encoder::ParseBitLength
+*
+* @Description	Parse a bit length given on commandline. Only `auto` and
+*               whole numbers from MIN_BIT_LENGTH to MAX_BIT_LENGTH are
+*               accepted, so that a typo is not taken for another length.
+*
+* @Input		string&		pszArgument     Commandline argument
+*
+* @Input		uint&		uiBitLength     Receives bit length,
+*                                           AUTO_BIT_LENGTH for `auto`
+*
+* @Return		bool                        Returns false if argument is
+*                                           not a supported bit length
+******************************************************************************/
+bool Encoder::ParseBitLength(const std::string &pszArgument,
+                             unsigned int &uiBitLength)
+{
+    if (pszArgument == "auto")
+    {
+        uiBitLength = AUTO_BIT_LENGTH;
+        return true;
+    }
+    
+    if (pszArgument.empty() || pszArgument.size() > 2 ||
+        pszArgument.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    
+    uiBitLength = atoi(pszArgument.c_str());
+    return uiBitLength != AUTO_BIT_LENGTH && IsValidBitLength(uiBitLength);
+}
 
 
 /******************************************************************************
 * @Function		Encoder::InitialiseTrie
 *
 * @Description	Initialise a Trie with ASCII characters.
+*               Every symbol is a new child of Root Node, so its node is
+*               added directly instead of searching Root Node for it.
 *
 * @Input		Node*		pRootNode       Pointer to Trie node
 *
@@ -31,139 +96,837 @@ uint16_t Encoder::s_u2Code = 0;
 ******************************************************************************/
 void Encoder::InitialiseTrie(Node *pRootNode)
 {
-    for(s_u2Code=0; s_u2Code<=255; s_u2Code++)
-        Trie::GetInstance()->AddWord(pRootNode,
-                                     std::string(1, (char) s_u2Code),
-                                     s_u2Code);
+    for(m_u2Code=0; m_u2Code<=255; m_u2Code++)
+    {
+        m_apSymbolNodes[m_u2Code] = m_Trie.NewNode((char) m_u2Code, m_u2Code,
+                                                   true);
+        pRootNode->AddChildNode(m_apSymbolNodes[m_u2Code]);
+    }
 }
 
 
 /******************************************************************************
-* @Function		Encoder::Encode
+* @Function		Encoder::Reset
 *
-* @Description	Encode a text file using LZW compression algorithm.
+* @Description	Start a new code stream with a fresh Trie.
 *
-* @Input		string		pszTextFile     Text file to be compressed
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::Reset()
+{
+    m_Trie.Clear();
+    InitialiseTrie(m_Trie.GetRootNode());
+    
+    m_bIsOverflow      = false;
+    m_bIsFlexible      = (m_eParseMode == PARSE_FLEXIBLE);
+    m_bIsHeaderWritten = false;
+    m_bHasStoredBlocks = false;
+    m_uiCodeLength     = AUTO_BIT_LENGTH;
+    m_pWord            = NULL;
+    m_pFlushedWord     = NULL;
+    m_pszLookahead.clear();
+    m_pszSample.clear();
+    m_pszBlock.clear();
+    m_vpAddedNodes.clear();
+}
+
+
+/******************************************************************************
+* @Function		Encoder::Reserve
+*
+* @Description	Construct Trie nodes in advance for the largest Trie of
+*               current bit length, so that later code streams of a
+*               long-lived Encoder never allocate Trie memory.
+*               Trie holds Root Node, a node per symbol and at most
+*               a node per code beyond them.
 *
 * @Return		void                        Returns nothing
 ******************************************************************************/
-void Encoder::Encode(std::string pszTextFile)
+void Encoder::Reserve()
 {
-    bool          bIsOverflow = false;
-    char          chSymbol;
-    std::string   pszWord = "";
-    std::string   pszNewWord = "";
-    Node          *pRootNode;
-    Node          *pWord = NULL;
-    char          *pszCompressedFile = new char[250];
-    std::ifstream hTextFile;
-    std::ofstream hCompressedFile;
+    unsigned int uiBitLength = m_uiBitLength;
     
-    // Construct a name of compressed file
-    pszTextFile.copy(pszCompressedFile, pszTextFile.rfind("."));
-    strcat(pszCompressedFile, ".lzw");
+    if (uiBitLength == AUTO_BIT_LENGTH || uiBitLength > AUTO_MAX_BIT_LENGTH)
+        uiBitLength = AUTO_MAX_BIT_LENGTH;
     
-    // Open a text file for reading text data and
-    // a compressed file for writing encrypted data
-    hTextFile.open(pszTextFile.c_str());
-    hCompressedFile.open(pszCompressedFile, std::ios::binary | std::ios::out);
+    m_Trie.Reserve(((size_t) 1 << uiBitLength) + 1);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::StartCodeStream
+*
+* @Description	Fix bit length of codes for current stream and write header.
+*
+* @Input		unsigned int	uiCodeLength    Bit length of codes
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::StartCodeStream(unsigned int uiCodeLength)
+{
+    m_uiCodeLength     = uiCodeLength;
+    m_uiMaxTableSize   = (unsigned int) pow(2.0, uiCodeLength);
+    m_bIsHeaderWritten = true;
     
-    // Create a EncryptStream using which encrypted data is written to a file
-    EncryptStream encout(hCompressedFile);
+    // Codes longer than 8 bits reserve FLUSH_CODE and STORED_CODE
+    if (uiCodeLength > 8)
+    {
+        m_u2Code           = FIRST_WORD_CODE;
+        m_bHasStoredBlocks = true;
+    }
     
-    // Initialise Trie data structure with ASCII characters
-    pRootNode = Trie::GetInstance()->GetRootNode();
-    InitialiseTrie(pRootNode);
+    m_encout.Reset(uiCodeLength);
+    m_encout.WriteHeader();
+}
+
+
+/******************************************************************************
+* @Function		Encoder::SelectCodeLength
+*
+* @Description	Select bit length of codes by encoding a sample of text with
+*               every bit length from AUTO_MIN_BIT_LENGTH to
+*               AUTO_MAX_BIT_LENGTH. Shortest bit length whose output is
+*               within AUTO_TOLERANCE_PERCENT of the smallest one is used.
+*
+* @Input		const char*	pchSample       Sample of text
+*
+* @Input		size_t		uiSize          Size of sample
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::SelectCodeLength(const char *pchSample, size_t uiSize)
+{
+    unsigned int        uiCodeLength;
+    size_t              uiBestSize = 0;
+    std::vector<size_t> vuiSizes;
+    std::string         pszCodes;
     
-    // Fetch text data character by character from a text file,
-    // till the EOF is reached
-    while (hTextFile.get(chSymbol))
+    // Trial encoding of sample with every bit length
+    for (uiCodeLength=AUTO_MIN_BIT_LENGTH;
+         uiCodeLength<=AUTO_MAX_BIT_LENGTH;
+         uiCodeLength++)
+    {
+        Encoder enc(uiCodeLength);
+        
+        pszCodes.clear();
+        enc.Update(pchSample, uiSize, pszCodes);
+        enc.Finish(pszCodes);
+        vuiSizes.push_back(pszCodes.size());
+        
+        if (uiBestSize == 0 || pszCodes.size() < uiBestSize)
+            uiBestSize = pszCodes.size();
+    }
+    
+    // Pick shortest bit length with nearly the smallest output
+    for (uiCodeLength=AUTO_MIN_BIT_LENGTH;
+         uiCodeLength<AUTO_MAX_BIT_LENGTH;
+         uiCodeLength++)
+        if (vuiSizes[uiCodeLength-AUTO_MIN_BIT_LENGTH] * 100 <=
+            uiBestSize * (100 + AUTO_TOLERANCE_PERCENT))
+            break;
+    
+    StartCodeStream(uiCodeLength);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::AssignCode
+*
+* @Description	Assign next code to ('word' + symbol), if Trie is not full.
+*               Flexible parsing may output a word whose extension already
+*               exists in Trie. Decoder still spends a code on it, so the
+*               code is consumed without adding a node.
+*
+* @Input		Node*		pWord           Trie node of 'word'
+*
+* @Input		char		chSymbol        Symbol following 'word'
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::AssignCode(Node *pWord, char chSymbol)
+{
+    if (m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
+    {
+        if (pWord->SearchChildNode(chSymbol) == NULL)
+            AddNode(pWord, chSymbol);
+        
+        if (m_u2Code != (m_uiMaxTableSize-1))
+            m_u2Code++;
+        else
+            m_bIsOverflow = true;
+    }
+}
+
+
+/******************************************************************************
+* @Function		Encoder::AddNode
+*
+* @Description	Add ('word' + symbol) into Trie with next code. Parent node
+*               is recorded, so that EncodeBlock() can remove the word again.
+*
+* @Input		Node*		pWord           Trie node of 'word'
+*
+* @Input		char		chSymbol        Symbol following 'word'
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::AddNode(Node *pWord, char chSymbol)
+{
+    pWord->AddChildNode(m_Trie.NewNode(chSymbol, m_u2Code, true));
+    m_vpAddedNodes.push_back(pWord);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::MatchLength
+*
+* @Description	Length of longest word in Trie matching beginning of text.
+*
+* @Input		const char*	pchText         Text to be matched
+*
+* @Input		size_t		uiSize          Size of text, at least 1
+*
+* @Return		size_t                      Returns length of longest word
+******************************************************************************/
+size_t Encoder::MatchLength(const char *pchText, size_t uiSize)
+{
+    Node   *pNode    = m_apSymbolNodes[(unsigned char) pchText[0]];
+    size_t uiLength  = 1;
+    
+    while (uiLength < uiSize &&
+           (pNode = pNode->SearchChildNode(pchText[uiLength])) != NULL)
+        uiLength++;
+    
+    return uiLength;
+}
+
+
+/******************************************************************************
+* @Function		Encoder::EndSampling
+*
+* @Description	Start code stream before a complete sample is supplied.
+*               At the end of text, bit length is selected from text
+*               sampled so far. At a flush point, the text goes on and
+*               a short sample tells little about it, hence the longest
+*               bit length is used.
+*
+* @Input		string&		pszCodes        Buffer to append codes to
+*
+* @Input		bool		bIsFinal        Whether the text ends here
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::EndSampling(std::string &pszCodes, bool bIsFinal)
+{
+    std::string pszSample;
+    
+    if (m_uiBitLength != AUTO_BIT_LENGTH)
     {
-        // Construct a new string using new extracted character
-        pszNewWord = pszWord + chSymbol;
+        StartCodeStream(m_uiBitLength);
+        return;
+    }
+    
+    pszSample.swap(m_pszSample);
+    if (bIsFinal)
+        SelectCodeLength(pszSample.data(), pszSample.size());
+    else
+        StartCodeStream(AUTO_MAX_BIT_LENGTH);
+    
+    Update(pszSample.data(), pszSample.size(), pszCodes);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::StartText
+*
+* @Description	Start code stream for a text supplied at once, selecting
+*               the same bit length as Update() and Finish() would.
+*
+* @Input		const char*	pchText         Whole text to be compressed
+*
+* @Input		size_t		uiSize          Size of text
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::StartText(const char *pchText, size_t uiSize)
+{
+    if (m_uiBitLength != AUTO_BIT_LENGTH)
+        StartCodeStream(m_uiBitLength);
+    else
+        SelectCodeLength(pchText, std::min(uiSize, AUTO_SAMPLE_SIZE));
+}
+
+
+/******************************************************************************
+* @Function		Encoder::ParseFlexible
+*
+* @Description	Encode buffered text using flexible parsing.
+*               Among all prefixes of the longest word at current position,
+*               output the one after which the next longest word reaches
+*               farthest into the text.
+*               Until Trie is full, every shorter prefix would spend a code
+*               on a word already in Trie, and Trie would hold fewer words
+*               than greedy parsing gives it; those lost words cost more
+*               than flexible parsing saves on many texts, above all with
+*               short codes. Hence the longest word is output until Trie
+*               is full, which keeps output the same as greedy parsing;
+*               a full Trie gains no more words, so from then on a shorter
+*               prefix is output whenever it reaches farther.
+*               Parsing stops where the decision depends on text not yet
+*               supplied; that text stays buffered for the next call.
+*
+* @Input		bool		bIsFinal        Whether the whole text is buffered
+*
+* @Return		Node*                       Returns Trie node of last word
+*                                           when whole text is encoded
+******************************************************************************/
+Node* Encoder::ParseFlexible(bool bIsFinal)
+{
+    const char    *pchText = m_pszLookahead.data();
+    size_t        uiSize   = m_pszLookahead.size();
+    size_t        uiPos    = 0;
+    size_t        uiEnd, uiLength, uiReach;
+    size_t        uiBestLength, uiBestReach;
+    bool          bIsPending;
+    Node          *pNode = NULL;
+    
+    while (uiPos < uiSize)
+    {
+        // Collect Trie nodes of every prefix of the longest word
+        m_vpMatch.clear();
+        pNode = m_apSymbolNodes[(unsigned char) pchText[uiPos]];
+        m_vpMatch.push_back(pNode);
         
-        // If new word exists in Trie,
-        // then update 'word' with new word
-        if (Trie::GetInstance()->SearchWord(pRootNode, pszNewWord) != NULL)
+        for (uiEnd=uiPos+1; uiEnd<uiSize; uiEnd++)
         {
-            pszWord = pszNewWord;
+            pNode = pNode->SearchChildNode(pchText[uiEnd]);
+            if (pNode == NULL)
+                break;
+            m_vpMatch.push_back(pNode);
         }
-        // If new word does not exist in Trie,
-        else
+        
+        // Longest word may continue into text not yet supplied
+        if (uiEnd == uiSize && !bIsFinal)
+            break;
+        
+        // Pick the prefix after which the next word reaches farthest,
+        // once Trie is full
+        uiBestLength  = m_vpMatch.size();
+        uiBestReach   = 0;
+        bIsPending    = false;
+        for (uiLength=m_vpMatch.size();
+             uiLength>=1 && !bIsPending && m_bIsOverflow; uiLength--)
         {
-            // Output the code for 'word'
-            pWord = Trie::GetInstance()->SearchWord(pRootNode, pszWord);
-            encout << pWord->GetCode();
+            if (uiPos + uiLength < uiSize)
+                uiReach = uiPos + uiLength +
+                          MatchLength(pchText + uiPos + uiLength,
+                                      uiSize - uiPos - uiLength);
+            else
+                uiReach = uiSize;
             
-            // Add new word into Trie, if Trie is not full
-            if (s_u2Code < m_uiMaxTableSize && !bIsOverflow)
+            // Next word may continue into text not yet supplied
+            if (uiReach == uiSize && !bIsFinal)
+                bIsPending = true;
+            else if (uiReach > uiBestReach)
             {
-                Trie::GetInstance()->AddWord(pRootNode,
-                                             pszNewWord,
-                                             s_u2Code);
-                if (s_u2Code != (m_uiMaxTableSize-1))
-                    s_u2Code++;
-                else
-                    bIsOverflow = true;
+                uiBestLength = uiLength;
+                uiBestReach  = uiReach;
             }
+        }
+        
+        if (bIsPending)
+            break;
+        
+        // Output the code for chosen word and
+        // add (word + following symbol) into Trie
+        pNode = m_vpMatch[uiBestLength-1];
+        m_encout << pNode->GetCode();
+        
+        uiPos += uiBestLength;
+        if (uiPos < uiSize)
+            AssignCode(pNode, pchText[uiPos]);
+    }
+    
+    m_pszLookahead.erase(0, uiPos);
+    
+    return m_pszLookahead.empty() ? pNode : NULL;
+}
+
+
+/******************************************************************************
+* @Function		Encoder::Update
+*
+* @Description	Encode a chunk of text data using LZW compression algorithm.
+*               Longest match found so far is kept in 'word' across calls,
+*               so a text may be supplied in chunks of any size.
+*               With AUTO_BIT_LENGTH, text is buffered until a sample of
+*               AUTO_SAMPLE_SIZE bytes selects the bit length.
+*               Codes longer than 8 bits are output for complete blocks of
+*               STORED_BLOCK_SIZE bytes, so that a block which does not
+*               compress can be stored as is.
+*
+* @Input		const char*	pchData         Text data to be compressed
+*
+* @Input		size_t		uiSize          Size of text data
+*
+* @Input		string&		pszCodes        Buffer to append codes to
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::Update(const char *pchData, size_t uiSize, std::string &pszCodes)
+{
+    size_t        uiSampled;
+    std::string   pszSample;
+    
+    m_encout.Attach(pszCodes);
+    
+    if (!m_bIsHeaderWritten)
+    {
+        if (m_uiBitLength != AUTO_BIT_LENGTH)
+        {
+            StartCodeStream(m_uiBitLength);
+        }
+        else if (m_pszSample.empty() && uiSize >= AUTO_SAMPLE_SIZE)
+        {
+            SelectCodeLength(pchData, AUTO_SAMPLE_SIZE);
+        }
+        else
+        {
+            // Buffer text until the sample is complete
+            uiSampled = AUTO_SAMPLE_SIZE - m_pszSample.size();
+            if (uiSampled > uiSize)
+                uiSampled = uiSize;
             
-            // Update 'word' with new extracted character
-            pszWord = chSymbol;
+            m_pszSample.append(pchData, uiSampled);
+            if (m_pszSample.size() < AUTO_SAMPLE_SIZE)
+                return;
+            
+            // Encode sample with selected bit length
+            pszSample.swap(m_pszSample);
+            SelectCodeLength(pszSample.data(), pszSample.size());
+            Update(pszSample.data(), pszSample.size(), pszCodes);
+            
+            pchData += uiSampled;
+            uiSize  -= uiSampled;
+        }
+    }
+    
+    // 8 bit codes leave no room for STORED_CODE
+    if (!m_bHasStoredBlocks)
+    {
+        EncodeText(pchData, uiSize);
+        return;
+    }
+    
+    // Encode text block by block; blocks complete within the chunk
+    // are encoded without buffering them
+    while (uiSize > 0)
+    {
+        if (m_pszBlock.empty() && uiSize >= STORED_BLOCK_SIZE)
+        {
+            EncodeBlock(pchData, STORED_BLOCK_SIZE, pszCodes);
+            pchData += STORED_BLOCK_SIZE;
+            uiSize  -= STORED_BLOCK_SIZE;
+            continue;
+        }
+        
+        uiSampled = STORED_BLOCK_SIZE - m_pszBlock.size();
+        if (uiSampled > uiSize)
+            uiSampled = uiSize;
+        
+        m_pszBlock.append(pchData, uiSampled);
+        pchData += uiSampled;
+        uiSize  -= uiSampled;
+        
+        if (m_pszBlock.size() == STORED_BLOCK_SIZE)
+        {
+            EncodeBlock(m_pszBlock.data(), m_pszBlock.size(), pszCodes);
+            m_pszBlock.clear();
         }
     }
+}
+
+
+/******************************************************************************
+* @Function		Encoder::EncodeText
+*
+* @Description	Encode a chunk of text data once header is written.
+*
+* @Input		const char*	pchData         Text data to be compressed
+*
+* @Input		size_t		uiSize          Size of text data
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::EncodeText(const char *pchData, size_t uiSize)
+{
+    if (uiSize > 0)
+        ExtendFlushedWord(pchData[0]);
     
-    // Output the code for remaining 'word'
-    pWord = Trie::GetInstance()->SearchWord(pRootNode, pszWord);
-    encout << pWord->GetCode();
+    if (m_bIsFlexible)
+    {
+        m_pszLookahead.append(pchData, uiSize);
+        ParseFlexible(false);
+        return;
+    }
     
-    // Clean memory occupied by Trie
-    Trie::DestroyInstance();
+    for (size_t i=0; i<uiSize; i++)
+        EncodeSymbol(pchData[i]);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::ExtendFlushedWord
+*
+* @Description	Word output at the last flush point is extended by the first
+*               symbol after it, as Decoder does.
+*
+* @Input		char		chSymbol        First symbol after flush point
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::ExtendFlushedWord(char chSymbol)
+{
+    if (m_pFlushedWord != NULL)
+    {
+        AssignCode(m_pFlushedWord, chSymbol);
+        m_pFlushedWord = NULL;
+    }
+}
+
+
+/******************************************************************************
+* @Function		Encoder::EndWord
+*
+* @Description	Output the code for pending 'word'. Word is left to be
+*               extended by the first symbol that follows, as Decoder does.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::EndWord()
+{
+    Node *pWord;
     
-    // Close files
-    hTextFile.close();
-    hCompressedFile.close();
+    if (m_bIsFlexible)
+    {
+        pWord = ParseFlexible(true);
+        if (pWord != NULL)
+            m_pFlushedWord = pWord;
+    }
+    else if (m_pWord != NULL)
+    {
+        m_encout << m_pWord->GetCode();
+        m_pFlushedWord = m_pWord;
+        m_pWord        = NULL;
+    }
 }
 
 
-/* Helper */
-void ShowUsage(std::string pszExecutableName)
+/******************************************************************************
+* @Function		Encoder::EncodeBlock
+*
+* @Description	Encode a block of text, or store it as is when its codes
+*               would take more space than the block itself.
+*               A block of high byte entropy is stored right away.
+*               Otherwise the block is encoded on trial, recording words
+*               added into Trie; if it does not pay off, output and words
+*               are removed again, so Trie matches Decoder's Map, which
+*               learns nothing from stored text.
+*               Every block ends its last word, so its codes hold exactly
+*               the text of the block.
+*
+* @Input		const char*	pchBlock        Block of text
+*
+* @Input		size_t		uiSize          Size of block
+*
+* @Input		string&		pszCodes        Buffer codes are appended to
+*
+* @Input		bool		bIsFlushed      Whether block ends at a flush point
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::EncodeBlock(const char *pchBlock, size_t uiSize,
+                          std::string &pszCodes, bool bIsFlushed)
+{
+    if (BeginBlock(pchBlock, uiSize, pszCodes))
+    {
+        EncodeText(pchBlock, uiSize);
+        EndBlock(pchBlock, uiSize, pszCodes, bIsFlushed);
+    }
+}
+
+
+/******************************************************************************
+* @Function		Encoder::BeginBlock
+*
+* @Description	Store a block of high byte entropy right away. Otherwise
+*               remember the state needed to undo trial encoding of
+*               the block, which the caller performs next.
+*
+* @Input		const char*	pchBlock        Block of text
+*
+* @Input		size_t		uiSize          Size of block
+*
+* @Input		string&		pszCodes        Buffer codes are appended to
+*
+* @Return		bool                        Returns true if block is to be
+*                                           encoded on trial
+******************************************************************************/
+bool Encoder::BeginBlock(const char *pchBlock, size_t uiSize,
+                         std::string &pszCodes)
+{
+    if (ByteEntropy(pchBlock, uiSize) > STORED_ENTROPY_BITS)
+    {
+        StoreBlock(pchBlock, uiSize);
+        return false;
+    }
+    
+    m_uiBlockStart = pszCodes.size();
+    m_BlockStream  = m_encout;
+    m_u2BlockCode  = m_u2Code;
+    m_bWasOverflow = m_bIsOverflow;
+    m_vpAddedNodes.clear();
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Encoder::EndBlock
+*
+* @Description	End the last word of a block encoded on trial. If its codes
+*               take more space than the block, undo trial encoding and
+*               store the block as is.
+*               At a flush point, padding after the codes counts against
+*               them, while a stored block ends on a byte boundary anyway.
+*
+* @Input		const char*	pchBlock        Block of text
+*
+* @Input		size_t		uiSize          Size of block
+*
+* @Input		string&		pszCodes        Buffer codes are appended to
+*
+* @Input		bool		bIsFlushed      Whether block ends at a flush point
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::EndBlock(const char *pchBlock, size_t uiSize,
+                       std::string &pszCodes, bool bIsFlushed)
+{
+    EndWord();
+    
+    if (bIsFlushed && !m_encout.IsAligned())
+    {
+        m_encout << FLUSH_CODE;
+        m_encout.Flush();
+    }
+    
+    if (pszCodes.size() - m_uiBlockStart <= uiSize + STORED_BLOCK_OVERHEAD)
+        return;
+    
+    // Undo trial encoding, removing words in reverse order of addition
+    while (!m_vpAddedNodes.empty())
+    {
+        m_vpAddedNodes.back()->RemoveLastChildNode();
+        m_vpAddedNodes.pop_back();
+        m_Trie.ReleaseLastNode();
+    }
+    
+    pszCodes.resize(m_uiBlockStart);
+    m_encout      = m_BlockStream;
+    m_u2Code      = m_u2BlockCode;
+    m_bIsOverflow = m_bWasOverflow;
+    
+    StoreBlock(pchBlock, uiSize);
+}
+
+
+/******************************************************************************
+* @Function		Encoder::StoreBlock
+*
+* @Description	Output a block of text as is: STORED_CODE, padding up to
+*               a byte boundary, length of block and the block itself.
+*
+* @Input		const char*	pchBlock        Block of text
+*
+* @Input		size_t		uiSize          Size of block,
+*                                           at most STORED_BLOCK_SIZE
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::StoreBlock(const char *pchBlock, size_t uiSize)
 {
-    std::cerr << "Usage: " << pszExecutableName << " <File Path> <Bit Length>\n"
-    << "\tFile Path\t\t Path of text file to be encoded.\n"
-    << "\tBit Length\t\t N-bit representation of code."
-    << std::endl;
+    char achLength[STORED_LENGTH_SIZE];
+    
+    m_encout << STORED_CODE;
+    m_encout.Flush();
+    
+    achLength[0] = (char) ((uiSize >> 8) & 0xff);
+    achLength[1] = (char) (uiSize & 0xff);
+    m_encout.WriteBytes(achLength, STORED_LENGTH_SIZE);
+    m_encout.WriteBytes(pchBlock, uiSize);
+    
+    // Decoder starts a new 'word' after stored text
+    m_pFlushedWord = NULL;
 }
 
 
-/* Entry point */
-int main(int argc, const char *argv[])
+/******************************************************************************
+* @Function		Encoder::Flush
+*
+* @Description	Output codes for all text supplied so far and pad codes to
+*               a byte boundary, so that Decoder can deliver the whole text
+*               up to this point as soon as it receives the codes.
+*               Unlike Finish(), Trie is kept and encoding continues, so
+*               the text that follows still benefits from earlier words.
+*               When codes end within a byte, FLUSH_CODE tells Decoder
+*               to skip the padding.
+*               Partial block is stored as is when its codes do not pay off,
+*               as a complete block would be, so each flush adds at most
+*               STORED_BLOCK_OVERHEAD bytes besides the text.
+*
+* @Input		string&		pszCodes        Buffer to append codes to
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::Flush(std::string &pszCodes)
 {
-    std::string  pszTextFile;
-    unsigned int uiBitLength;
+    m_encout.Attach(pszCodes);
     
-    // Parse commandline arguments
-    if (argc != 3)
+    if (!m_bIsHeaderWritten)
+        EndSampling(pszCodes, false);
+    
+    if (!m_pszBlock.empty())
     {
-        ShowUsage(argv[0]);
-        return -1;
+        EncodeBlock(m_pszBlock.data(), m_pszBlock.size(), pszCodes, true);
+        m_pszBlock.clear();
     }
     
-    pszTextFile = argv[1];
-    uiBitLength = atoi(argv[2]);
+    // Codes 8 bits long are never buffered in blocks
+    EndWord();
     
-    // Create 'Encoder' instance
-    Encoder *enc = new Encoder(uiBitLength);
+    // 8 bit codes never leave partial bytes
+    if (!m_encout.IsAligned())
+    {
+        m_encout << FLUSH_CODE;
+        m_encout.Flush();
+    }
+}
+
+
+/******************************************************************************
+* @Function		Encoder::Finish
+*
+* @Description	Output the code for remaining 'word' and pad codes
+*               to a byte boundary. A stream too short to complete
+*               the sample selects bit length from what was supplied.
+*               The last, partial block may be stored as is.
+*
+* @Input		string&		pszCodes        Buffer to append codes to
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Encoder::Finish(std::string &pszCodes)
+{
+    m_encout.Attach(pszCodes);
+    
+    if (!m_bIsHeaderWritten)
+        EndSampling(pszCodes, true);
     
-    // Start encoding
-    std::cout << __FUNCTION__
-              << "(): Encrypting \'"
-              << pszTextFile
-              << "\'.."
-              << std::endl;
-    enc->Encode(pszTextFile);
-    std::cout << __FUNCTION__
-              << "(): Encrypting finished!"
-              << std::endl;
+    if (!m_pszBlock.empty())
+    {
+        EncodeBlock(m_pszBlock.data(), m_pszBlock.size(), pszCodes);
+        m_pszBlock.clear();
+    }
+    
+    if (m_bIsFlexible)
+        ParseFlexible(true);
+    
+    if (m_pWord != NULL)
+        m_encout << m_pWord->GetCode();
+    
+    m_encout.Flush();
+    m_pWord = NULL;
+}
+
+
+/******************************************************************************
+* @Function		Encoder::Encode
+*
+* @Description	Encode a text stream using LZW compression algorithm.
+*
+* @Input		istream&	TextStream          Text data to be compressed
+*
+* @Input		ostream&	CompressedStream    Stream to write codes to
+*
+* @Return		bool                            Returns true on success
+******************************************************************************/
+bool Encoder::Encode(std::istream &TextStream, std::ostream &CompressedStream)
+{
+    std::string pszText(STREAM_CHUNK_SIZE, '\0');
+    std::string pszCodes;
+    
+    Reset();
+    
+    // Fetch text data chunk by chunk from a text stream,
+    // till the EOF is reached
+    while (TextStream.read(&pszText[0], pszText.size()) ||
+           TextStream.gcount() > 0)
+    {
+        Update(pszText.data(), (size_t) TextStream.gcount(), pszCodes);
+        CompressedStream.write(pszCodes.data(), pszCodes.size());
+        pszCodes.clear();
+    }
+    
+    Finish(pszCodes);
+    CompressedStream.write(pszCodes.data(), pszCodes.size());
+    
+    return !TextStream.bad() && CompressedStream.good();
+}
+
+
+/******************************************************************************
+* @Function		Encoder::Encode
+*
+* @Description	Encode a text file using LZW compression algorithm.
+*
+* @Input		string		pszTextFile     Text file to be compressed
+*
+* @Return		bool                        Returns true on success
+******************************************************************************/
+bool Encoder::Encode(std::string pszTextFile)
+{
+    bool          bIsEncoded;
+    std::string   pszCompressedFile;
+    std::ifstream hTextFile;
+    std::ofstream hCompressedFile;
+    
+    // Construct a name of compressed file
+    pszCompressedFile = pszTextFile.substr(0, pszTextFile.rfind(".")) + ".lzw";
+    
+    // Open a text file for reading text data and
+    // a compressed file for writing encrypted data
+    hTextFile.open(pszTextFile.c_str(), std::ios::binary);
+    if (!hTextFile.is_open())
+    {
+        std::cerr << "Unable to open \'" << pszTextFile << "\'." << std::endl;
+        return false;
+    }
+    
+    hCompressedFile.open(pszCompressedFile.c_str(),
+                         std::ios::binary | std::ios::out);
+    if (!hCompressedFile.is_open())
+    {
+        std::cerr << "Unable to create \'" << pszCompressedFile << "\'."
+                  << std::endl;
+        return false;
+    }
+    
+    bIsEncoded = Encode(hTextFile, hCompressedFile);
+    
+    // Close files
+    hTextFile.close();
+    hCompressedFile.close();
     
-    return 0;
+    return bIsEncoded;
 }
@@ -0,0 +1,118 @@
+/******************************************************************************//*!
+* @File          EncoderMain.cpp
+* 
+* @Title         Command line utility for LZW Encoder.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements `Encoder` utility, a thin wrapper
+*                around LZW library.
+*
+*//*******************************************************************************/ 
+
+#include "Encoder.h"
+#include "Daemon.h"
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName
+    << " <File Path> <Bit Length> [--flexible] [--daemon]\n"
+    << "\tFile Path\t\t Path of text file to be encoded.\n"
+    << "\tBit Length\t\t N-bit representation of code (8 to 16),\n"
+    << "\t\t\t\t or `auto` to select it by sampling the text.\n"
+    << "\t--flexible\t\t Use flexible parsing: slower, smaller output.\n"
+    << "\t--daemon\t\t Let `lzwd` encode the file; implied when\n"
+    << "\t\t\t\t " << DAEMON_SOCKET_ENV << " is set. Encodes locally"
+    << " if lzwd is not running."
+    << std::endl;
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    std::string  pszTextFile;
+    unsigned int uiBitLength;
+    unsigned int uiCodeLength;
+    ParseMode    eParseMode = PARSE_GREEDY;
+    const char   *pszSocket = getenv(DAEMON_SOCKET_ENV);
+    bool         bUseDaemon = pszSocket != NULL && *pszSocket != '\0';
+    std::string  pszOption;
+    DaemonStatus eStatus;
+    
+    // Parse commandline arguments
+    if (argc < 3)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    
+    for (int i=3; i<argc; i++)
+    {
+        pszOption = argv[i];
+        if (pszOption == "--flexible")
+            eParseMode = PARSE_FLEXIBLE;
+        else if (pszOption == "--daemon")
+            bUseDaemon = true;
+        else
+        {
+            ShowUsage(argv[0]);
+            return -1;
+        }
+    }
+    
+    pszTextFile = argv[1];
+    if (!Encoder::ParseBitLength(argv[2], uiBitLength))
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    
+    // Start encoding
+    std::cout << __FUNCTION__
+              << "(): Encrypting \'"
+              << pszTextFile
+              << "\'.."
+              << std::endl;
+    
+    // Hand file over to 'lzwd', if it is running
+    eStatus = DAEMON_UNAVAILABLE;
+    if (bUseDaemon)
+    {
+        DaemonClient client;
+        
+        eStatus = client.Encode(pszTextFile, uiBitLength, eParseMode,
+                                uiCodeLength);
+        if (eStatus == DAEMON_ERROR)
+            return -1;
+        if (eStatus == DAEMON_UNAVAILABLE)
+            std::cerr << "lzwd is not available at \'"
+                      << client.GetSocketPath()
+                      << "\'; encoding locally." << std::endl;
+    }
+    
+    // Otherwise create 'Encoder' instance
+    if (eStatus == DAEMON_UNAVAILABLE)
+    {
+        Encoder *enc = new Encoder(uiBitLength);
+        enc->SetParseMode(eParseMode);
+        
+        if (!enc->Encode(pszTextFile))
+            return -1;
+        uiCodeLength = enc->GetCodeLength();
+    }
+    
+    std::cout << __FUNCTION__
+              << "(): Encrypting finished with "
+              << uiCodeLength
+              << " bit codes!"
+              << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,87 @@
+/******************************************************************************//*!
+* @File          GrepMain.cpp
+* 
+* @Title         Command line utility for LZW Matcher.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements `lzwgrep` utility, a thin wrapper
+*                around LZW library, searching compressed files without
+*                decompressing them.
+*
+*//*******************************************************************************/ 
+
+#include "Encoder.h"
+#include "Matcher.h"
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName
+    << " [-c] <Pattern> <File Path> [Bit Length]\n"
+    << "\t-c\t\t\t Only print number of occurrences.\n"
+    << "\tPattern\t\t\t Bytes to search for.\n"
+    << "\tFile Path\t\t Path of encrypted file to be searched.\n"
+    << "\tBit Length\t\t N-bit representation of code (8 to 16); only\n"
+    << "\t\t\t\t needed for files written without header\n"
+    << "\t\t\t\t (default 16).\n"
+    << "Offsets of occurrences in decompressed file are printed one per line.\n"
+    << "Exit status is 0 if pattern occurs, 1 if not and -1 on error."
+    << std::endl;
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    std::string  pszPattern;
+    std::string  pszCompressedFile;
+    unsigned int uiBitLength = 16;
+    bool         bIsCountOnly = false;
+    int          iArg = 1;
+
+    // Parse commandline arguments
+    if (argc > 1 && std::string(argv[1]) == "-c")
+    {
+        bIsCountOnly = true;
+        iArg++;
+    }
+
+    if (argc - iArg != 2 && argc - iArg != 3)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+
+    pszPattern        = argv[iArg];
+    pszCompressedFile = argv[iArg+1];
+    if (argc - iArg == 3 && (!Encoder::ParseBitLength(argv[iArg+2], uiBitLength) ||
+                             uiBitLength == AUTO_BIT_LENGTH))
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+
+    if (pszPattern.empty() || pszPattern.size() > MATCH_MAX_PATTERN_LENGTH)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+
+    // Create 'Matcher' instance
+    Matcher *mat = new Matcher(pszPattern, uiBitLength);
+
+    // Start searching
+    if (!mat->Search(pszCompressedFile, bIsCountOnly))
+        return -1;
+    
+    if (bIsCountOnly)
+        std::cout << mat->GetMatchCount() << std::endl;
+    
+    return mat->GetMatchCount() > 0 ? 0 : 1;
+}
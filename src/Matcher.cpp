@@ -0,0 +1,601 @@
+/******************************************************************************//*!
+* @File          Matcher.cpp
+* 
+* @Title         Implementation of LZW Matcher.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements member functions of LZW Matcher class.
+*
+*//*******************************************************************************/ 
+
+#include "Matcher.h"
+
+
+/******************************************************************************
+* @Function		Matcher::InitialisePattern
+*
+* @Description	Build automata recognising pattern:
+*               1. KMP automaton, whose state is the length of the longest
+*                  pattern prefix ending at current position.
+*               2. Border table, telling whether a pattern prefix is a suffix
+*                  of the text ending in a KMP state.
+*               3. Suffix automaton, recognising substrings of pattern;
+*                  its terminal states recognise suffixes of pattern.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Matcher::InitialisePattern()
+{
+    const size_t          uiLength = m_pszPattern.size();
+    unsigned char         uchSymbol;
+    uint32_t              uiFallback;
+    size_t                i;
+    size_t                j;
+    int32_t               iLast;
+    int32_t               iStates;
+    int32_t               iState;
+    int32_t               iNext;
+    int32_t               iClone;
+    int32_t               iPrev;
+    std::vector<uint32_t> vuFallback(uiLength + 1, 0);
+    std::vector<int32_t>  viLink(2 * uiLength + 1, MATCH_NONE);
+    std::vector<uint32_t> vuDepth(2 * uiLength + 1, 0);
+
+    // KMP automaton: state 'uiLength' behaves as its fallback state,
+    // so that overlapping occurrences are found
+    m_vuNextState.assign((uiLength + 1) * 256, 0);
+    m_vuNextState[(unsigned char) m_pszPattern[0]] = 1;
+    uiFallback = 0;
+    for (j=1; j<=uiLength; j++)
+    {
+        for (i=0; i<256; i++)
+            m_vuNextState[j * 256 + i] = m_vuNextState[uiFallback * 256 + i];
+
+        vuFallback[j] = uiFallback;
+        if (j < uiLength)
+        {
+            uchSymbol = (unsigned char) m_pszPattern[j];
+            m_vuNextState[j * 256 + uchSymbol] = (uint32_t) j + 1;
+            uiFallback = m_vuNextState[uiFallback * 256 + uchSymbol];
+        }
+    }
+
+    // Border table: row j marks j and the states it falls back to
+    m_vbIsBorder.assign((uiLength + 1) * (uiLength + 1), false);
+    m_vbIsBorder[0] = true;
+    for (j=1; j<=uiLength; j++)
+    {
+        for (i=0; i<=uiLength; i++)
+            m_vbIsBorder[j * (uiLength + 1) + i] =
+                m_vbIsBorder[vuFallback[j] * (uiLength + 1) + i];
+
+        m_vbIsBorder[j * (uiLength + 1) + j] = true;
+    }
+
+    // Suffix automaton, built online symbol by symbol
+    m_viNextFactor.assign((2 * uiLength + 1) * 256, MATCH_NONE);
+    iLast   = 0;
+    iStates = 1;
+    for (j=0; j<uiLength; j++)
+    {
+        uchSymbol = (unsigned char) m_pszPattern[j];
+        iState    = iStates++;
+        vuDepth[iState] = vuDepth[iLast] + 1;
+
+        for (iPrev=iLast;
+             iPrev != MATCH_NONE && m_viNextFactor[iPrev * 256 + uchSymbol] == MATCH_NONE;
+             iPrev=viLink[iPrev])
+            m_viNextFactor[iPrev * 256 + uchSymbol] = iState;
+
+        if (iPrev == MATCH_NONE)
+        {
+            viLink[iState] = 0;
+        }
+        else
+        {
+            iNext = m_viNextFactor[iPrev * 256 + uchSymbol];
+            if (vuDepth[iPrev] + 1 == vuDepth[iNext])
+            {
+                viLink[iState] = iNext;
+            }
+            else
+            {
+                iClone = iStates++;
+                vuDepth[iClone] = vuDepth[iPrev] + 1;
+                viLink[iClone]  = viLink[iNext];
+                std::copy(m_viNextFactor.begin() + iNext * 256,
+                          m_viNextFactor.begin() + iNext * 256 + 256,
+                          m_viNextFactor.begin() + iClone * 256);
+
+                for (;
+                     iPrev != MATCH_NONE && m_viNextFactor[iPrev * 256 + uchSymbol] == iNext;
+                     iPrev=viLink[iPrev])
+                    m_viNextFactor[iPrev * 256 + uchSymbol] = iClone;
+
+                viLink[iNext]  = iClone;
+                viLink[iState] = iClone;
+            }
+        }
+
+        iLast = iState;
+    }
+
+    m_viNextFactor.resize(iStates * 256);
+    m_vbIsSuffix.assign(iStates, false);
+    for (iState=iLast; iState > 0; iState=viLink[iState])
+        m_vbIsSuffix[iState] = true;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::InitialiseMap
+*
+* @Description	Initialise a Map with ASCII characters.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Matcher::InitialiseMap()
+{
+    m_vPhrases.resize(65536);
+    for(m_u2Code=0; m_u2Code<=255; m_u2Code++)
+        AddPhrase(m_u2Code, MATCH_NONE, (unsigned char) m_u2Code);
+}
+
+
+/******************************************************************************
+* @Function		Matcher::AddPhrase
+*
+* @Description	Add ('word' of prefix code + symbol) into Map. Phrase is
+*               derived from the one of prefix code in constant time.
+*
+* @Input		uint16_t		u2Code          Code of new word
+*
+* @Input		int32_t			iPrefix         Code of 'word', or MATCH_NONE
+*
+* @Input		unsigned char	uchSymbol       Symbol appended to 'word'
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Matcher::AddPhrase(uint16_t u2Code, int32_t iPrefix, unsigned char uchSymbol)
+{
+    Phrase &NewPhrase = m_vPhrases[u2Code];
+
+    if (iPrefix == MATCH_NONE)
+    {
+        NewPhrase.uiLength    = 1;
+        NewPhrase.uiState     = m_vuNextState[uchSymbol];
+        NewPhrase.iFactor     = m_viNextFactor[uchSymbol];
+        NewPhrase.iLastMatch  = MATCH_NONE;
+        NewPhrase.iLastSuffix = MATCH_NONE;
+        NewPhrase.uchFirst    = uchSymbol;
+    }
+    else
+    {
+        const Phrase &PrefixPhrase = m_vPhrases[iPrefix];
+
+        NewPhrase.uiLength    = PrefixPhrase.uiLength + 1;
+        NewPhrase.uiState     = m_vuNextState[PrefixPhrase.uiState * 256 + uchSymbol];
+        NewPhrase.iFactor     = PrefixPhrase.iFactor == MATCH_NONE ? MATCH_NONE
+                              : m_viNextFactor[PrefixPhrase.iFactor * 256 + uchSymbol];
+        NewPhrase.iLastMatch  = PrefixPhrase.iLastMatch;
+        NewPhrase.iLastSuffix = PrefixPhrase.iLastSuffix;
+        NewPhrase.uchFirst    = PrefixPhrase.uchFirst;
+    }
+
+    NewPhrase.iPrefix   = iPrefix;
+    NewPhrase.uchSymbol = uchSymbol;
+
+    if (NewPhrase.uiState == m_pszPattern.size())
+        NewPhrase.iLastMatch = u2Code;
+
+    if (NewPhrase.iFactor != MATCH_NONE && m_vbIsSuffix[NewPhrase.iFactor])
+        NewPhrase.iLastSuffix = u2Code;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::MatchPhrase
+*
+* @Description	Report occurrences of pattern ending within word of a code,
+*               and advance KMP state past the word.
+*               A word that is not a substring of pattern cannot be covered
+*               by an occurrence, so the KMP state after it does not depend
+*               on preceding text, and occurrences are either:
+*               - crossing: pattern prefix ending the text so far, followed
+*                 by a prefix of word being the rest of pattern, or
+*               - internal: ending within a prefix of word.
+*               Both are found by following chains of Phrases.
+*               Only a word that is a substring of pattern, hence no longer
+*               than pattern, is run symbol by symbol through KMP automaton.
+*
+* @Input		uint16_t	u2Code          Code of word
+*
+* @Input		vector<uint64_t>&	vu8Offsets  Offsets of occurrences
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Matcher::MatchPhrase(uint16_t u2Code, std::vector<uint64_t> &vu8Offsets)
+{
+    const Phrase   &WordPhrase = m_vPhrases[u2Code];
+    const uint32_t uiLength    = (uint32_t) m_pszPattern.size();
+    int32_t        iCode;
+    uint32_t       i;
+    uint32_t       uiPrefixLength;
+    size_t         uiFirst;
+
+    if (WordPhrase.iFactor != MATCH_NONE)
+    {
+        m_pszSymbols.resize(WordPhrase.uiLength);
+        iCode = u2Code;
+        for (i=WordPhrase.uiLength; i>0; i--)
+        {
+            m_pszSymbols[i-1] = (char) m_vPhrases[iCode].uchSymbol;
+            iCode = m_vPhrases[iCode].iPrefix;
+        }
+
+        for (i=0; i<WordPhrase.uiLength; i++)
+        {
+            m_uiState = m_vuNextState[m_uiState * 256 +
+                                      (unsigned char) m_pszSymbols[i]];
+            if (m_uiState == uiLength)
+                vu8Offsets.push_back(m_u8Offset + i + 1 - uiLength);
+        }
+
+        m_u8Offset += WordPhrase.uiLength;
+        return;
+    }
+
+    // Crossing occurrences, found from the longest prefix of word down
+    uiFirst = vu8Offsets.size();
+    iCode   = WordPhrase.iLastSuffix;
+    while (iCode != MATCH_NONE)
+    {
+        uiPrefixLength = m_vPhrases[iCode].uiLength;
+        if (uiPrefixLength < uiLength &&
+            m_vbIsBorder[m_uiState * (uiLength + 1) + uiLength - uiPrefixLength])
+            vu8Offsets.push_back(m_u8Offset - (uiLength - uiPrefixLength));
+
+        iCode = m_vPhrases[iCode].iPrefix;
+        if (iCode != MATCH_NONE)
+            iCode = m_vPhrases[iCode].iLastSuffix;
+    }
+    std::reverse(vu8Offsets.begin() + uiFirst, vu8Offsets.end());
+
+    // Internal occurrences, found from the longest prefix of word down
+    uiFirst = vu8Offsets.size();
+    iCode   = WordPhrase.iLastMatch;
+    while (iCode != MATCH_NONE)
+    {
+        vu8Offsets.push_back(m_u8Offset + m_vPhrases[iCode].uiLength - uiLength);
+
+        iCode = m_vPhrases[iCode].iPrefix;
+        if (iCode != MATCH_NONE)
+            iCode = m_vPhrases[iCode].iLastMatch;
+    }
+    std::reverse(vu8Offsets.begin() + uiFirst, vu8Offsets.end());
+
+    m_uiState   = WordPhrase.uiState;
+    m_u8Offset += WordPhrase.uiLength;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::Reset
+*
+* @Description	Start searching a new code stream with a fresh Map.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void Matcher::Reset()
+{
+    if (m_bIsPatternValid)
+        InitialiseMap();
+
+    m_uiCodeLength  = 0;
+    m_bIsOverflow   = false;
+    m_bIsCorrupt    = false;
+    m_bHasFlushCode  = false;
+    m_bHasStoredCode = false;
+    m_bIsStoredBlock = false;
+    m_uiStoredSize   = 0;
+    m_pszStoredLength.clear();
+    m_iWord         = MATCH_NONE;
+    m_uiState       = 0;
+    m_u8Offset      = 0;
+    m_u8MatchCount  = 0;
+    m_decin.Reset(LEGACY_CODE_LENGTH);
+}
+
+
+/******************************************************************************
+* @Function		Matcher::ReadHeader
+*
+* @Description	Read header of compressed data and fix bit length of codes,
+*               in the same way as Decoder.
+*
+* @Return		bool                        Returns true once bit length
+*                                           of codes is known
+******************************************************************************/
+bool Matcher::ReadHeader()
+{
+    switch (m_decin.ReadHeader())
+    {
+        case HEADER_PENDING:
+            return false;
+
+        case HEADER_CORRUPT:
+            m_bIsCorrupt = true;
+            return false;
+
+        default:
+            break;
+    }
+
+    m_uiCodeLength = m_decin.GetCodeLength();
+    if (m_decin.GetVersion() == 0)
+        m_uiMaxTableSize = (unsigned int) pow(2.0, std::min(m_uiBitLength, 16u));
+    else
+        m_uiMaxTableSize = (unsigned int) pow(2.0, m_uiCodeLength);
+
+    m_bHasFlushCode  = m_decin.HasFlushCode();
+    m_bHasStoredCode = m_decin.HasStoredCode();
+    m_u2Code         = m_decin.GetFirstWordCode();
+
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::ReadStoredBlock
+*
+* @Description	Search text of a stored block, running it through KMP
+*               automaton. Length and text of the block may be split
+*               across chunks.
+*
+* @Input		vector<uint64_t>&	vu8Offsets  Offsets of occurrences
+*
+* @Return		bool                        Returns true once the whole
+*                                           block is searched
+******************************************************************************/
+bool Matcher::ReadStoredBlock(std::vector<uint64_t> &vu8Offsets)
+{
+    const uint32_t uiLength = (uint32_t) m_pszPattern.size();
+    size_t         i;
+
+    if (m_pszStoredLength.size() < STORED_LENGTH_SIZE)
+    {
+        m_decin.ReadBytes(m_pszStoredLength,
+                          STORED_LENGTH_SIZE - m_pszStoredLength.size());
+        if (m_pszStoredLength.size() < STORED_LENGTH_SIZE)
+            return false;
+
+        m_uiStoredSize = ((unsigned char) m_pszStoredLength[0] << 8) |
+                         (unsigned char) m_pszStoredLength[1];
+    }
+
+    m_pszSymbols.clear();
+    m_uiStoredSize -= m_decin.ReadBytes(m_pszSymbols, m_uiStoredSize);
+
+    for (i=0; i<m_pszSymbols.size(); i++)
+    {
+        m_uiState = m_vuNextState[m_uiState * 256 +
+                                  (unsigned char) m_pszSymbols[i]];
+        if (m_uiState == uiLength)
+            vu8Offsets.push_back(m_u8Offset + i + 1 - uiLength);
+    }
+    m_u8Offset += m_pszSymbols.size();
+
+    if (m_uiStoredSize > 0)
+        return false;
+
+    m_bIsStoredBlock = false;
+    m_pszStoredLength.clear();
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::Update
+*
+* @Description	Search a chunk of encrypted data for pattern. Map grows
+*               exactly as Decoder's does, one Phrase per code.
+*
+* @Input		const char*	pchData         Encrypted data to be searched
+*
+* @Input		size_t		uiSize          Size of encrypted data
+*
+* @Input		vector<uint64_t>&	vu8Offsets  Buffer to append offsets
+*                                               of occurrences to
+*
+* @Return		bool                        Returns false on corrupt data
+*                                           or invalid pattern
+******************************************************************************/
+bool Matcher::Update(const char *pchData, size_t uiSize,
+                     std::vector<uint64_t> &vu8Offsets)
+{
+    uint16_t      u2Code;
+    unsigned char uchFirst;
+    size_t        uiFirst = vu8Offsets.size();
+
+    if (m_bIsCorrupt || !m_bIsPatternValid)
+        return false;
+
+    m_decin.Feed(pchData, uiSize);
+
+    if (m_uiCodeLength == 0 && !ReadHeader())
+        return !m_bIsCorrupt;
+
+    while (true)
+    {
+        if (m_bIsStoredBlock && !ReadStoredBlock(vu8Offsets))
+            break;
+
+        if (!(m_decin >> u2Code))
+            break;
+
+        if (u2Code == FLUSH_CODE && m_bHasFlushCode)
+        {
+            m_decin.Align();
+            continue;
+        }
+
+        // Text stored as is is searched symbol by symbol;
+        // the next code starts a new 'word'
+        if (u2Code == STORED_CODE && m_bHasStoredCode)
+        {
+            m_decin.Align();
+            m_bIsStoredBlock = true;
+            m_iWord          = MATCH_NONE;
+            continue;
+        }
+
+        // Fetch first symbol of new word.
+        // Note: Only the code being added next may be missing,
+        //       its word being ('word' + first symbol of 'word').
+        if (u2Code < m_u2Code || (m_bIsOverflow && u2Code == m_u2Code))
+        {
+            uchFirst = m_vPhrases[u2Code].uchFirst;
+        }
+        else if (m_iWord != MATCH_NONE && u2Code == m_u2Code &&
+                 m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
+        {
+            uchFirst = m_vPhrases[m_iWord].uchFirst;
+        }
+        else
+        {
+            m_bIsCorrupt = true;
+            return false;
+        }
+
+        // Add ('word' + first symbol of new word) into Map,
+        // if Map is not full and this is not the first code
+        if (m_iWord != MATCH_NONE && m_u2Code < m_uiMaxTableSize && !m_bIsOverflow)
+        {
+            AddPhrase(m_u2Code, m_iWord, uchFirst);
+            if (m_u2Code != (m_uiMaxTableSize-1))
+                m_u2Code++;
+            else
+                m_bIsOverflow = true;
+        }
+
+        MatchPhrase(u2Code, vu8Offsets);
+
+        // Update 'word' with a new word
+        m_iWord = u2Code;
+    }
+
+    m_u8MatchCount += vu8Offsets.size() - uiFirst;
+
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		Matcher::Finish
+*
+* @Description	Check whether code stream ended on a code boundary.
+*
+* @Return		bool                        Returns false on truncated data
+******************************************************************************/
+bool Matcher::Finish()
+{
+    if (m_uiCodeLength == 0 && m_decin.HasPartialHeader())
+        return false;
+
+    return m_bIsPatternValid && !m_bIsCorrupt && !m_bIsStoredBlock &&
+           !m_decin.HasPartialCode();
+}
+
+
+/******************************************************************************
+* @Function		Matcher::Search
+*
+* @Description	Search a compressed stream for pattern.
+*
+* @Input		istream&	CompressedStream    Encrypted data to be searched
+*
+* @Input		ostream*	pOffsetStream       Stream to write offsets of
+*                                               occurrences to, one per line,
+*                                               or NULL to count them only
+*
+* @Return		bool                            Returns true on success
+******************************************************************************/
+bool Matcher::Search(std::istream &CompressedStream, std::ostream *pOffsetStream)
+{
+    std::string           pszCodes(STREAM_CHUNK_SIZE, '\0');
+    std::vector<uint64_t> vu8Offsets;
+    size_t                i;
+
+    if (!m_bIsPatternValid)
+        return false;
+
+    Reset();
+
+    // Fetch encrypted data chunk by chunk from a compressed stream,
+    // till the EOF is reached
+    while (CompressedStream.read(&pszCodes[0], pszCodes.size()) ||
+           CompressedStream.gcount() > 0)
+    {
+        if (!Update(pszCodes.data(), (size_t) CompressedStream.gcount(),
+                    vu8Offsets))
+        {
+            std::cerr << "Compressed data is corrupt." << std::endl;
+            return false;
+        }
+
+        for (i=0; pOffsetStream != NULL && i<vu8Offsets.size(); i++)
+            *pOffsetStream << vu8Offsets[i] << '\n';
+        vu8Offsets.clear();
+    }
+
+    if (!Finish())
+    {
+        std::cerr << "Compressed data is truncated." << std::endl;
+        return false;
+    }
+
+    if (pOffsetStream == NULL)
+        return !CompressedStream.bad();
+
+    pOffsetStream->flush();
+
+    return !CompressedStream.bad() && pOffsetStream->good();
+}
+
+
+/******************************************************************************
+* @Function		Matcher::Search
+*
+* @Description	Search a compressed file for pattern.
+*
+* @Input		string		pszCompressedFile     Compressed file to be searched
+*
+* @Input		bool		bIsCountOnly          Count occurrences without
+*                                                 writing their offsets
+*
+* @Return		bool                        Returns true on success
+******************************************************************************/
+bool Matcher::Search(std::string pszCompressedFile, bool bIsCountOnly)
+{
+    bool          bIsSearched;
+    std::ifstream hCompressedFile;
+
+    hCompressedFile.open(pszCompressedFile.c_str(), std::ios_base::binary);
+    if (!hCompressedFile.is_open())
+    {
+        std::cerr << "Unable to open \'" << pszCompressedFile << "\'."
+                  << std::endl;
+        return false;
+    }
+
+    bIsSearched = Search(hCompressedFile, bIsCountOnly ? NULL : &std::cout);
+
+    hCompressedFile.close();
+
+    return bIsSearched;
+}
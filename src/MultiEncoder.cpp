@@ -0,0 +1,299 @@
+/******************************************************************************//*!
+* @File          MultiEncoder.cpp
+* 
+* @Title         Implementation of LZW MultiEncoder.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements member functions of LZW MultiEncoder
+*                class.
+*
+*//*******************************************************************************/ 
+
+#include "MultiEncoder.h"
+
+
+/******************************************************************************
+* @Function		MultiEncoder::MultiEncoder
+*
+* @Description	Create an Encoder for every lane.
+*
+* @Input		unsigned int	uiBitLength     Bit length of codes, or
+*                                           AUTO_BIT_LENGTH
+*
+* @Input		unsigned int	uiLaneCount     Number of texts encoded in
+*                                           lockstep, 1 to MULTI_MAX_LANES
+******************************************************************************/
+MultiEncoder::MultiEncoder(unsigned int uiBitLength, unsigned int uiLaneCount)
+{
+    Lane lane;
+    
+    if (uiLaneCount < 1 || uiLaneCount > MULTI_MAX_LANES)
+    {
+        std::cerr << "Lane count should be between 1 and "
+                  << MULTI_MAX_LANES << "." << std::endl;
+        uiLaneCount = std::max(1u, std::min(uiLaneCount, MULTI_MAX_LANES));
+    }
+    
+    m_uiBitLength = uiBitLength;
+    m_eParseMode  = PARSE_GREEDY;
+    m_apchTexts   = NULL;
+    m_auiSizes    = NULL;
+    m_apszCodes   = NULL;
+    m_uiTextCount = 0;
+    m_uiNextText  = 0;
+    
+    memset(&lane, 0, sizeof(lane));
+    for (unsigned int i=0; i<uiLaneCount; i++)
+    {
+        lane.pEncoder = new Encoder(uiBitLength);
+        m_vLanes.push_back(lane);
+    }
+}
+
+
+/******************************************************************************
+* @Function		MultiEncoder::~MultiEncoder
+*
+* @Description	Release Encoders of all lanes.
+******************************************************************************/
+MultiEncoder::~MultiEncoder()
+{
+    for (size_t i=0; i<m_vLanes.size(); i++)
+        delete m_vLanes[i].pEncoder;
+}
+
+
+/******************************************************************************
+* @Function		MultiEncoder::StartText
+*
+* @Description	Start encoding the next text on a lane with a fresh Trie.
+*
+* @Input		Lane&		lane            Lane to be started
+*
+* @Return		bool                        Returns false if no text is left
+******************************************************************************/
+bool MultiEncoder::StartText(Lane &lane)
+{
+    Encoder *pEncoder = lane.pEncoder;
+    
+    if (m_uiNextText == m_uiTextCount)
+        return false;
+    
+    lane.pchText  = m_apchTexts[m_uiNextText];
+    lane.uiSize   = m_auiSizes[m_uiNextText];
+    lane.pszCodes = &m_apszCodes[m_uiNextText];
+    lane.uiPos    = 0;
+    lane.bIsBlock = false;
+    m_uiNextText++;
+    
+    pEncoder->SetBitLength(m_uiBitLength);
+    pEncoder->SetParseMode(PARSE_GREEDY);
+    pEncoder->Reset();
+    pEncoder->m_encout.Attach(*lane.pszCodes);
+    pEncoder->StartText(lane.pchText, lane.uiSize);
+    
+    return true;
+}
+
+
+/******************************************************************************
+* @Function		MultiEncoder::NextBlock
+*
+* @Description	Move a lane to its next block of symbols. A block encoded
+*               on trial is ended first; blocks stored right away are
+*               skipped; a text without symbols left is finished, and the
+*               next text is started.
+*               Codes longer than 8 bits are encoded block by block, as
+*               Encoder::Update() does; otherwise the whole text is
+*               a single block.
+*
+* @Input		Lane&		lane            Lane to be moved
+*
+* @Return		bool                        Returns false if lane is idle
+*                                           as no text is left
+******************************************************************************/
+bool MultiEncoder::NextBlock(Lane &lane)
+{
+    Encoder *pEncoder = lane.pEncoder;
+    
+    while (true)
+    {
+        if (lane.bIsBlock)
+        {
+            pEncoder->EndBlock(lane.pchText + lane.uiBlockStart,
+                               lane.uiBlockEnd - lane.uiBlockStart,
+                               *lane.pszCodes);
+            lane.bIsBlock = false;
+        }
+    
+        if (lane.pchText != NULL && lane.uiPos == lane.uiSize)
+        {
+            pEncoder->Finish(*lane.pszCodes);
+            lane.pchText = NULL;
+        }
+    
+        if (lane.pchText == NULL && !StartText(lane))
+            return false;
+    
+        lane.uiBlockStart = lane.uiPos;
+        if (!pEncoder->m_bHasStoredBlocks)
+        {
+            lane.uiBlockEnd = lane.uiSize;
+            if (lane.uiPos < lane.uiBlockEnd)
+                return true;
+    
+            continue;
+        }
+    
+        lane.uiBlockEnd = std::min(lane.uiPos + STORED_BLOCK_SIZE, lane.uiSize);
+        if (lane.uiPos == lane.uiBlockEnd)
+            continue;
+    
+        if (pEncoder->BeginBlock(lane.pchText + lane.uiBlockStart,
+                                 lane.uiBlockEnd - lane.uiBlockStart,
+                                 *lane.pszCodes))
+        {
+            pEncoder->ExtendFlushedWord(lane.pchText[lane.uiPos]);
+            lane.bIsBlock = true;
+            return true;
+        }
+    
+        // Block is stored as is
+        lane.uiPos = lane.uiBlockEnd;
+    }
+}
+
+
+/******************************************************************************
+* @Function		MultiEncoder::Encode
+*
+* @Description	Encode independent texts in lockstep. Every round encodes
+*               one symbol of every lane and prefetches the node it moved
+*               to; a second pass prefetches the children of that node,
+*               which the next round searches. By the time a lane is
+*               visited again, its memory accesses have overlapped those
+*               of all other lanes instead of waiting one after another.
+*               Lanes finishing a text start the next one, so texts of
+*               different sizes keep every lane busy.
+*
+* @Input		size_t		uiCount         Number of texts
+*
+* @Input		const char**	apchTexts       Texts to be compressed
+*
+* @Input		const size_t*	auiSizes        Sizes of texts
+*
+* @Input		string*		apszCodes       Buffers to append codes of
+*                                           every text to
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void MultiEncoder::Encode(size_t uiCount, const char *const *apchTexts,
+                          const size_t *auiSizes, std::string *apszCodes)
+{
+    bool    bIsActive;
+    Encoder *pEncoder;
+    size_t  uiBack;
+    
+    // A single lane gains nothing from lockstep, and flexible parsing
+    // looks ahead beyond the current symbol
+    if (m_vLanes.size() == 1 || m_eParseMode == PARSE_FLEXIBLE)
+    {
+        pEncoder = m_vLanes[0].pEncoder;
+        pEncoder->SetBitLength(m_uiBitLength);
+        pEncoder->SetParseMode(m_eParseMode);
+        
+        for (size_t i=0; i<uiCount; i++)
+        {
+            pEncoder->Reset();
+            pEncoder->Update(apchTexts[i], auiSizes[i], apszCodes[i]);
+            pEncoder->Finish(apszCodes[i]);
+        }
+        return;
+    }
+    
+    m_apchTexts   = apchTexts;
+    m_auiSizes    = auiSizes;
+    m_apszCodes   = apszCodes;
+    m_uiTextCount = uiCount;
+    m_uiNextText  = 0;
+    
+    for (size_t i=0; i<m_vLanes.size(); i++)
+    {
+        m_vLanes[i].pchText    = NULL;
+        m_vLanes[i].uiPos      = 0;
+        m_vLanes[i].uiBlockEnd = 0;
+        m_vLanes[i].bIsBlock   = false;
+    }
+    
+    do
+    {
+        bIsActive = false;
+        uiBack    = m_vLanes.size() / 2;
+        
+        // Encode a symbol of every lane
+        for (size_t i=0; i<m_vLanes.size(); i++)
+        {
+            Lane &lane = m_vLanes[i];
+            Lane &back = m_vLanes[uiBack];
+            
+            if (++uiBack == m_vLanes.size())
+                uiBack = 0;
+            
+            if (lane.uiPos != lane.uiBlockEnd || NextBlock(lane))
+            {
+                pEncoder = lane.pEncoder;
+                pEncoder->EncodeSymbol(lane.pchText[lane.uiPos++]);
+                pEncoder->m_pWord->Prefetch();
+                bIsActive = true;
+            }
+            
+            // Node of 'word' of the lane visited half a round ago has
+            // arrived by now; its children are searched half a round later
+            if (back.pchText != NULL && back.pEncoder->m_pWord != NULL)
+                back.pEncoder->m_pWord->PrefetchChildren();
+        }
+    }
+    while (bIsActive);
+    
+    m_apchTexts = NULL;
+    m_auiSizes  = NULL;
+    m_apszCodes = NULL;
+}
+
+
+/******************************************************************************
+* @Function		MultiEncoder::Encode
+*
+* @Description	Encode independent texts in lockstep.
+*
+* @Input		vector<string>&	vpszTexts       Texts to be compressed
+*
+* @Input		vector<string>&	vpszCodes       Buffers to append codes of
+*                                           every text to; resized to
+*                                           the number of texts
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+void MultiEncoder::Encode(const std::vector<std::string> &vpszTexts,
+                          std::vector<std::string> &vpszCodes)
+{
+    std::vector<const char*> vpchTexts;
+    std::vector<size_t>      vuiSizes;
+    
+    vpszCodes.resize(vpszTexts.size());
+    if (vpszTexts.empty())
+        return;
+    
+    for (size_t i=0; i<vpszTexts.size(); i++)
+    {
+        vpchTexts.push_back(vpszTexts[i].data());
+        vuiSizes.push_back(vpszTexts[i].size());
+    }
+    
+    Encode(vpszTexts.size(), &vpchTexts[0], &vuiSizes[0], &vpszCodes[0]);
+}
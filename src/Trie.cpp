@@ -16,8 +16,19 @@
 #include "Trie.h"
 
 
-/* Initializing Trie's static data member. */
-Trie *Trie::s_pTrie = NULL;
+/******************************************************************************
+* @Function		Trie::~Trie
+*
+* @Description	Destroy all nodes and release their blocks.
+******************************************************************************/
+Trie::~Trie()
+{
+    for (size_t i=0; i<m_uiConstructedCount; i++)
+        m_vpBlocks[i / TRIE_BLOCK_NODES][i % TRIE_BLOCK_NODES].~Node();
+    
+    for (size_t i=0; i<m_vpchMemory.size(); i++)
+        delete[] m_vpchMemory[i];
+}
 
 
 /******************************************************************************
@@ -34,34 +45,104 @@ Node* const Trie::GetRootNode()
 
 
 /******************************************************************************
-* @Function		Trie::GetInstance
+* @Function		Trie::Clear
 *
-* @Description  Get an instance of singleton Trie class.
+* @Description	Remove all words from Trie data structure.
+*               Root Node is replaced, so pointers to old nodes become invalid.
+*               Nodes are kept for reuse rather than released.
 *
-* @Return       Trie*                   Returns pointer to Trie class
+* @Return		void					Returns nothing
 ******************************************************************************/
-Trie* Trie::GetInstance()
+void Trie::Clear()
 {
-    if (!s_pTrie)
-        s_pTrie = new Trie;
-        
-    return s_pTrie;
+    m_uiNodeCount = 0;
+    m_pRoot       = NewNode();
+}
+
+
+/******************************************************************************
+* @Function		Trie::AddBlock
+*
+* @Description	Add a block of TRIE_BLOCK_NODES nodes aligned to a cache line.
+*               Nodes of the block are not constructed yet.
+*
+* @Return		void					Returns nothing
+******************************************************************************/
+void Trie::AddBlock()
+{
+    char   *pchMemory;
+    size_t uiOffset;
+    
+    pchMemory = new char[TRIE_BLOCK_NODES * sizeof(Node) + TRIE_CACHE_LINE];
+    m_vpchMemory.push_back(pchMemory);
+    
+    uiOffset = (TRIE_CACHE_LINE - (uintptr_t) pchMemory % TRIE_CACHE_LINE) %
+               TRIE_CACHE_LINE;
+    m_vpBlocks.push_back((Node *) (pchMemory + uiOffset));
 }
 
 
 /******************************************************************************
-* @Function		Trie::DestroyInstance
+* @Function		Trie::Reserve
+*
+* @Description	Construct nodes in advance, so that a Trie growing up to
+*               the given number of nodes neither allocates memory nor
+*               touches fresh pages.
 *
-* @Description	Destroy an instance of singleton Trie class.
+* @Input		size_t		uiNodeCount	Number of nodes, including Root Node
 *
 * @Return		void					Returns nothing
 ******************************************************************************/
-void Trie::DestroyInstance()
+void Trie::Reserve(size_t uiNodeCount)
 {
-    if (s_pTrie)
-        delete s_pTrie;
+    while (m_uiConstructedCount < uiNodeCount)
+    {
+        if (m_uiConstructedCount == m_vpBlocks.size() * TRIE_BLOCK_NODES)
+            AddBlock();
         
-    s_pTrie = NULL;
+        new (&m_vpBlocks[m_uiConstructedCount / TRIE_BLOCK_NODES]
+                        [m_uiConstructedCount % TRIE_BLOCK_NODES]) Node();
+        m_uiConstructedCount++;
+    }
+}
+
+
+/******************************************************************************
+* @Function		Trie::NewNode
+*
+* @Description	Allocate a node after the one allocated last. A node
+*               constructed before is reused; otherwise one is constructed,
+*               in a new block if the last block is full.
+*
+* @Input		char		chSymbol	Symbol of node
+*
+* @Input		uint16_t	u2Code		Equivalent code of node
+*
+* @Input		bool		bIsWord		Whether node is marked as a 'Word'
+*
+* @Return		Node*					Returns pointer to new Trie node
+******************************************************************************/
+Node* Trie::NewNode(char chSymbol, uint16_t u2Code, bool bIsWord)
+{
+    Node *pNode;
+    
+    if (m_uiNodeCount == m_vpBlocks.size() * TRIE_BLOCK_NODES)
+        AddBlock();
+    
+    pNode = &m_vpBlocks[m_uiNodeCount / TRIE_BLOCK_NODES]
+                       [m_uiNodeCount % TRIE_BLOCK_NODES];
+    
+    if (m_uiNodeCount < m_uiConstructedCount)
+        pNode->Renew(chSymbol, u2Code, bIsWord);
+    else
+    {
+        new (pNode) Node(chSymbol, u2Code, bIsWord);
+        m_uiConstructedCount++;
+    }
+    
+    m_uiNodeCount++;
+    
+    return pNode;
 }
 
 
@@ -100,7 +181,7 @@ void Trie::AddWord(Node *pNode, std::string pszWord, uint16_t u2Code)
     pChildNode = pNode->SearchChildNode(chSymbol);
     if (pChildNode == NULL)
     {
-        pChildNode = new Node(chSymbol);
+        pChildNode = NewNode(chSymbol);
         pNode->AddChildNode(pChildNode);
     }
     
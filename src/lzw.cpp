@@ -0,0 +1,505 @@
+/******************************************************************************//*!
+* @File          lzw.cpp
+* 
+* @Title         Implementation of C interface of LZW library.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements C interface of LZW library on top of
+*                LZW Encoder, MultiEncoder, Decoder and Matcher classes.
+* 
+*//*******************************************************************************/ 
+
+#include <new>
+
+#include "lzw.h"
+#include "Encoder.h"
+#include "MultiEncoder.h"
+#include "Decoder.h"
+#include "Matcher.h"
+
+
+/* Version of LZW library. */
+#define LZW_VERSION "1.8.0"
+
+/* Limits of C interface are those of the classes behind it; compilation
+   fails on an array of negative size if they ever differ. */
+#define LZW_ASSERT_SAME(name, a, b) typedef char name[(a) == (b) ? 1 : -1]
+
+LZW_ASSERT_SAME(LzwAutoBitLength, LZW_AUTO_BIT_LENGTH, AUTO_BIT_LENGTH);
+LZW_ASSERT_SAME(LzwMinBitLength, LZW_MIN_BIT_LENGTH, MIN_BIT_LENGTH);
+LZW_ASSERT_SAME(LzwMaxBitLength, LZW_MAX_BIT_LENGTH, MAX_BIT_LENGTH);
+LZW_ASSERT_SAME(LzwMaxLanes, LZW_MAX_LANES, MULTI_MAX_LANES);
+LZW_ASSERT_SAME(LzwMaxPatternLength, LZW_MAX_PATTERN_LENGTH,
+                MATCH_MAX_PATTERN_LENGTH);
+
+
+/******************************************************************************
+* @Struct		lzw_stream
+*
+* @Description	Streaming context behind the opaque C handle.
+******************************************************************************/
+struct lzw_stream
+{
+    lzw_mode    eMode;
+    Encoder     *pEncoder;
+    Decoder     *pDecoder;
+    std::string pszOutput;
+    size_t      uiReadOffset;
+    bool        bIsFinished;
+};
+
+
+/* Helper */
+static unsigned int LegacyBitLength(unsigned int uiBitLength)
+{
+    return uiBitLength == LZW_AUTO_BIT_LENGTH ? LEGACY_CODE_LENGTH
+                                              : uiBitLength;
+}
+
+
+/* Helper */
+static bool IsValidFlags(unsigned int uiFlags)
+{
+    return (uiFlags & ~(unsigned int) LZW_FLAG_FLEXIBLE) == 0;
+}
+
+
+/* Helper */
+static void ApplyFlags(Encoder &enc, unsigned int uiFlags)
+{
+    if (uiFlags & LZW_FLAG_FLEXIBLE)
+    {
+        enc.SetParseMode(PARSE_FLEXIBLE);
+        enc.Reset();
+    }
+}
+
+
+/* Helper */
+static int CopyOutput(const std::string &pszOutput,
+                      void *pDst, size_t *puiDstSize)
+{
+    size_t uiCapacity = *puiDstSize;
+
+    *puiDstSize = pszOutput.size();
+    if (pszOutput.size() > uiCapacity)
+        return LZW_ERROR_BUFFER;
+
+    if (!pszOutput.empty())
+        memcpy(pDst, pszOutput.data(), pszOutput.size());
+
+    return LZW_OK;
+}
+
+
+const char *lzw_version(void)
+{
+    return LZW_VERSION;
+}
+
+
+const char *lzw_strerror(int status)
+{
+    switch (status)
+    {
+        case LZW_OK:            return "success";
+        case LZW_ERROR_PARAM:   return "invalid argument";
+        case LZW_ERROR_BUFFER:  return "output buffer too small";
+        case LZW_ERROR_DATA:    return "corrupt or truncated compressed data";
+        case LZW_ERROR_MEMORY:  return "out of memory";
+        case LZW_ERROR_STATE:   return "call not valid in current state";
+        default:                return "unknown status";
+    }
+}
+
+
+size_t lzw_compress_bound(size_t src_size)
+{
+    // Every block is stored as is in the worst case,
+    // after the header and followed by padding.
+    return STREAM_HEADER_SIZE + src_size +
+           STORED_BLOCK_OVERHEAD * ((src_size + STORED_BLOCK_SIZE - 1) /
+                                    STORED_BLOCK_SIZE) + 1;
+}
+
+
+int lzw_compress(const void *src, size_t src_size,
+                 void *dst, size_t *dst_size,
+                 unsigned int bit_length)
+{
+    return lzw_compress_ex(src, src_size, dst, dst_size, bit_length, 0);
+}
+
+
+int lzw_compress_ex(const void *src, size_t src_size,
+                    void *dst, size_t *dst_size,
+                    unsigned int bit_length, unsigned int flags)
+{
+    if ((src == NULL && src_size > 0) || dst_size == NULL ||
+        (dst == NULL && *dst_size > 0) ||
+        !Encoder::IsValidBitLength(bit_length) || !IsValidFlags(flags))
+        return LZW_ERROR_PARAM;
+
+    try
+    {
+        Encoder     enc(bit_length);
+        std::string pszCodes;
+
+        ApplyFlags(enc, flags);
+        pszCodes.reserve(lzw_compress_bound(src_size));
+        enc.Update((const char *) src, src_size, pszCodes);
+        enc.Finish(pszCodes);
+
+        return CopyOutput(pszCodes, dst, dst_size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+}
+
+
+int lzw_compress_batch(size_t count,
+                       const void *const *src, const size_t *src_size,
+                       void *const *dst, size_t *dst_size,
+                       unsigned int bit_length, unsigned int flags,
+                       unsigned int lanes)
+{
+    size_t i;
+    int    iStatus = LZW_OK;
+
+    if ((count > 0 && (src == NULL || src_size == NULL ||
+                       dst == NULL || dst_size == NULL)) ||
+        !Encoder::IsValidBitLength(bit_length) || !IsValidFlags(flags) ||
+        lanes > LZW_MAX_LANES)
+        return LZW_ERROR_PARAM;
+
+    for (i=0; i<count; i++)
+        if ((src[i] == NULL && src_size[i] > 0) ||
+            (dst[i] == NULL && dst_size[i] > 0))
+            return LZW_ERROR_PARAM;
+
+    if (count == 0)
+        return LZW_OK;
+
+    try
+    {
+        MultiEncoder             menc(bit_length, lanes == 0 ?
+                                                  MULTI_DEFAULT_LANES : lanes);
+        std::vector<std::string> vpszCodes(count);
+
+        if (flags & LZW_FLAG_FLEXIBLE)
+            menc.SetParseMode(PARSE_FLEXIBLE);
+
+        menc.Encode(count, (const char *const *) src, src_size, &vpszCodes[0]);
+
+        // Deliver every output that fits, even if some do not
+        for (i=0; i<count; i++)
+            if (CopyOutput(vpszCodes[i], dst[i], &dst_size[i]) != LZW_OK)
+                iStatus = LZW_ERROR_BUFFER;
+
+        return iStatus;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+}
+
+
+int lzw_decompress(const void *src, size_t src_size,
+                   void *dst, size_t *dst_size,
+                   unsigned int bit_length)
+{
+    if ((src == NULL && src_size > 0) || dst_size == NULL ||
+        (dst == NULL && *dst_size > 0) ||
+        !Encoder::IsValidBitLength(bit_length))
+        return LZW_ERROR_PARAM;
+
+    try
+    {
+        Decoder     dec(LegacyBitLength(bit_length));
+        std::string pszText;
+
+        if (!dec.Update((const char *) src, src_size, pszText) ||
+            !dec.Finish())
+            return LZW_ERROR_DATA;
+
+        return CopyOutput(pszText, dst, dst_size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+}
+
+
+lzw_stream *lzw_stream_create(lzw_mode mode, unsigned int bit_length)
+{
+    return lzw_stream_create_ex(mode, bit_length, 0);
+}
+
+
+lzw_stream *lzw_stream_create_ex(lzw_mode mode,
+                                 unsigned int bit_length,
+                                 unsigned int flags)
+{
+    lzw_stream *pStream;
+
+    if ((mode != LZW_COMPRESS && mode != LZW_DECOMPRESS) ||
+        !Encoder::IsValidBitLength(bit_length) || !IsValidFlags(flags))
+        return NULL;
+
+    pStream = new (std::nothrow) lzw_stream;
+    if (pStream == NULL)
+        return NULL;
+
+    pStream->eMode        = mode;
+    pStream->pEncoder     = NULL;
+    pStream->pDecoder     = NULL;
+    pStream->uiReadOffset = 0;
+    pStream->bIsFinished  = false;
+
+    try
+    {
+        if (mode == LZW_COMPRESS)
+        {
+            pStream->pEncoder = new Encoder(bit_length);
+            ApplyFlags(*pStream->pEncoder, flags);
+        }
+        else
+            pStream->pDecoder = new Decoder(LegacyBitLength(bit_length));
+    }
+    catch (const std::bad_alloc &)
+    {
+        delete pStream;
+        return NULL;
+    }
+
+    return pStream;
+}
+
+
+void lzw_stream_destroy(lzw_stream *stream)
+{
+    if (stream == NULL)
+        return;
+
+    delete stream->pEncoder;
+    delete stream->pDecoder;
+    delete stream;
+}
+
+
+int lzw_stream_reset(lzw_stream *stream)
+{
+    if (stream == NULL)
+        return LZW_ERROR_PARAM;
+
+    try
+    {
+        if (stream->eMode == LZW_COMPRESS)
+            stream->pEncoder->Reset();
+        else
+            stream->pDecoder->Reset();
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+
+    stream->pszOutput.clear();
+    stream->uiReadOffset = 0;
+    stream->bIsFinished  = false;
+
+    return LZW_OK;
+}
+
+
+int lzw_stream_write(lzw_stream *stream, const void *src, size_t src_size)
+{
+    if (stream == NULL || (src == NULL && src_size > 0))
+        return LZW_ERROR_PARAM;
+
+    if (stream->bIsFinished)
+        return LZW_ERROR_STATE;
+
+    try
+    {
+        if (stream->eMode == LZW_COMPRESS)
+        {
+            stream->pEncoder->Update((const char *) src, src_size,
+                                     stream->pszOutput);
+        }
+        else if (!stream->pDecoder->Update((const char *) src, src_size,
+                                           stream->pszOutput))
+        {
+            return LZW_ERROR_DATA;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+
+    return LZW_OK;
+}
+
+
+int lzw_stream_flush(lzw_stream *stream)
+{
+    if (stream == NULL)
+        return LZW_ERROR_PARAM;
+
+    if (stream->bIsFinished)
+        return LZW_ERROR_STATE;
+
+    if (stream->eMode == LZW_DECOMPRESS)
+        return LZW_OK;
+
+    try
+    {
+        stream->pEncoder->Flush(stream->pszOutput);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+
+    return LZW_OK;
+}
+
+
+int lzw_stream_finish(lzw_stream *stream)
+{
+    if (stream == NULL)
+        return LZW_ERROR_PARAM;
+
+    if (stream->bIsFinished)
+        return LZW_ERROR_STATE;
+
+    stream->bIsFinished = true;
+
+    try
+    {
+        if (stream->eMode == LZW_COMPRESS)
+            stream->pEncoder->Finish(stream->pszOutput);
+        else if (!stream->pDecoder->Finish())
+            return LZW_ERROR_DATA;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+
+    return LZW_OK;
+}
+
+
+unsigned int lzw_stream_bit_length(const lzw_stream *stream)
+{
+    if (stream == NULL)
+        return 0;
+
+    if (stream->eMode == LZW_COMPRESS)
+        return stream->pEncoder->GetCodeLength();
+
+    return stream->pDecoder->GetCodeLength();
+}
+
+
+size_t lzw_stream_pending(const lzw_stream *stream)
+{
+    if (stream == NULL)
+        return 0;
+
+    return stream->pszOutput.size() - stream->uiReadOffset;
+}
+
+
+size_t lzw_stream_read(lzw_stream *stream, void *dst, size_t dst_size)
+{
+    size_t uiSize;
+
+    if (stream == NULL || dst == NULL)
+        return 0;
+
+    uiSize = lzw_stream_pending(stream);
+    if (uiSize > dst_size)
+        uiSize = dst_size;
+
+    memcpy(dst, stream->pszOutput.data() + stream->uiReadOffset, uiSize);
+    stream->uiReadOffset += uiSize;
+
+    // Release buffer once every pending byte is read
+    if (stream->uiReadOffset == stream->pszOutput.size())
+    {
+        stream->pszOutput.clear();
+        stream->uiReadOffset = 0;
+    }
+
+    return uiSize;
+}
+
+
+int lzw_search(const void *src, size_t src_size,
+               const void *pattern, size_t pattern_size,
+               unsigned int bit_length,
+               lzw_match_callback callback, void *opaque,
+               uint64_t *match_count)
+{
+    if ((src == NULL && src_size > 0) || pattern == NULL ||
+        pattern_size == 0 || pattern_size > LZW_MAX_PATTERN_LENGTH ||
+        !Encoder::IsValidBitLength(bit_length))
+        return LZW_ERROR_PARAM;
+
+    if (match_count != NULL)
+        *match_count = 0;
+
+    try
+    {
+        Matcher               mat(std::string((const char *) pattern,
+                                              pattern_size),
+                                  LegacyBitLength(bit_length));
+        std::vector<uint64_t> vu8Offsets;
+        const char            *pchData = (const char *) src;
+        size_t                uiChunkSize;
+        size_t                i;
+
+        // Search chunk by chunk, so that offsets are delivered
+        // without collecting all of them
+        while (src_size > 0)
+        {
+            uiChunkSize = std::min(src_size, STREAM_CHUNK_SIZE);
+            if (!mat.Update(pchData, uiChunkSize, vu8Offsets))
+                return LZW_ERROR_DATA;
+
+            pchData  += uiChunkSize;
+            src_size -= uiChunkSize;
+
+            for (i=0; i<vu8Offsets.size(); i++)
+            {
+                if (match_count != NULL)
+                    (*match_count)++;
+
+                if (callback != NULL && callback(opaque, vu8Offsets[i]) != 0)
+                    return LZW_OK;
+            }
+            vu8Offsets.clear();
+        }
+
+        if (!mat.Finish())
+            return LZW_ERROR_DATA;
+
+        return LZW_OK;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return LZW_ERROR_MEMORY;
+    }
+}
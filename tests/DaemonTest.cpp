@@ -0,0 +1,784 @@
+/******************************************************************************//*!
+* @File          DaemonTest.cpp
+* 
+* @Title         Tests of LZW daemon and its client.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      POSIX
+* 
+* @Description   This file implements `lzwdtest`, which starts `lzwd` on a
+*                socket of its own and checks it through its protocol, its
+*                client and `Encoder` and `Decoder` utilities. Each check is
+*                run by name, so that CTest reports it apart.
+*
+*//*******************************************************************************/ 
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+#include <string>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+
+#include "Daemon.h"
+#include "lzw.h"
+
+
+/* Bit lengths every check is run with */
+static const unsigned int g_auiBitLengths[] = {AUTO_BIT_LENGTH, 8, 9, 12, 16};
+static const size_t       g_uiBitLengthCount = sizeof(g_auiBitLengths) /
+                                               sizeof(g_auiBitLengths[0]);
+
+/* Utilities under test, given on commandline */
+static std::string g_pszDaemonPath;
+static std::string g_pszEncoderPath;
+static std::string g_pszDecoderPath;
+
+/* Directory holding socket and files of a check */
+static std::string g_pszDirectory;
+
+/* Process of lzwd serving a check */
+static pid_t       g_iDaemonPid = -1;
+
+/* Number of failed expectations */
+static unsigned int g_uiFailures = 0;
+
+
+/* Helper */
+static void Expect(bool bIsTrue, const std::string &pszWhat)
+{
+    if (!bIsTrue)
+    {
+        std::cerr << "FAILED: " << pszWhat << std::endl;
+        g_uiFailures++;
+    }
+}
+
+
+/* Helper */
+static std::string ToString(uint64_t u8Value)
+{
+    std::ostringstream oss;
+    
+    oss << u8Value;
+    return oss.str();
+}
+
+
+/* Helper */
+static std::string Describe(const std::string &pszCase, unsigned int uiBitLength)
+{
+    return pszCase + " (bit length " + ToString(uiBitLength) + ")";
+}
+
+
+/* Helper */
+static uint32_t NextRandom(uint32_t &u4State)
+{
+    u4State = u4State * 1103515245u + 12345u;
+    return u4State >> 8;
+}
+
+
+/* Helper */
+static std::string MakeText(size_t uiSize, uint32_t u4Seed)
+{
+    static const char *apszWords[] = {"the ", "LZW ", "code ", "word ", "of ",
+                                      "Trie ", "and ", "dictionary ", "a ",
+                                      "compression\n", "to ", "symbol ",
+                                      "encoder ", "decoder ", "in ", "is "};
+    std::string pszText;
+    
+    while (pszText.size() < uiSize)
+        pszText += apszWords[NextRandom(u4Seed) % 16];
+    pszText.resize(uiSize);
+    
+    return pszText;
+}
+
+
+/* Helper */
+static std::string MakeRandom(size_t uiSize, uint32_t u4Seed)
+{
+    std::string pszData(uiSize, '\0');
+    
+    for (size_t i=0; i<uiSize; i++)
+        pszData[i] = (char) NextRandom(u4Seed);
+    
+    return pszData;
+}
+
+
+/* Helper */
+static std::vector<std::string> MakeSamples()
+{
+    std::vector<std::string> vpszSamples;
+    
+    vpszSamples.push_back("");
+    vpszSamples.push_back("a");
+    vpszSamples.push_back(std::string(5000, 'x'));
+    vpszSamples.push_back(MakeText(200000, 1));
+    vpszSamples.push_back(MakeRandom(5000, 2));
+    vpszSamples.push_back(MakeText(70000, 3) + MakeRandom(70000, 4) +
+                          MakeText(70000, 5));
+    
+    return vpszSamples;
+}
+
+
+/* Helper */
+static std::string Compress(const std::string &pszText, unsigned int uiBitLength,
+                            unsigned int uiFlags)
+{
+    size_t      uiSize = lzw_compress_bound(pszText.size());
+    std::string pszCodes(uiSize, '\0');
+    
+    if (lzw_compress_ex(pszText.data(), pszText.size(), &pszCodes[0], &uiSize,
+                        uiBitLength, uiFlags) != LZW_OK)
+        uiSize = 0;
+    pszCodes.resize(uiSize);
+    
+    return pszCodes;
+}
+
+
+/* Helper */
+static std::string ReadFile(const std::string &pszFile)
+{
+    std::ifstream      ifs(pszFile.c_str(), std::ios::binary);
+    std::ostringstream oss;
+    
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+
+/* Helper */
+static void WriteFile(const std::string &pszFile, const std::string &pszData)
+{
+    std::ofstream ofs(pszFile.c_str(), std::ios::binary);
+    
+    ofs.write(pszData.data(), pszData.size());
+}
+
+
+/* Helper */
+static int RunCommand(const std::string &pszCommand)
+{
+    int iStatus = system(pszCommand.c_str());
+    
+    return (iStatus != -1 && WIFEXITED(iStatus)) ? WEXITSTATUS(iStatus) : -1;
+}
+
+
+/* Helper */
+static std::string SocketPath()
+{
+    return g_pszDirectory + "/lzwd.sock";
+}
+
+
+/* Helper */
+static int ConnectDaemon()
+{
+    struct sockaddr_un Address;
+    std::string        pszSocketPath = SocketPath();
+    int                hSocket;
+    
+    memset(&Address, 0, sizeof(Address));
+    Address.sun_family = AF_UNIX;
+    memcpy(Address.sun_path, pszSocketPath.data(), pszSocketPath.size());
+    
+    hSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (hSocket < 0)
+        return -1;
+    
+    if (connect(hSocket, (struct sockaddr *) &Address, sizeof(Address)) < 0)
+    {
+        close(hSocket);
+        return -1;
+    }
+    
+    return hSocket;
+}
+
+
+/* Helper */
+static bool SendAll(int hSocket, const std::string &pszData)
+{
+    const char *pchData = pszData.data();
+    size_t     uiSize   = pszData.size();
+    ssize_t    iSent;
+    
+    while (uiSize > 0)
+    {
+        iSent = send(hSocket, pchData, uiSize, DAEMON_SEND_FLAGS);
+        if (iSent < 0 && errno == EINTR)
+            continue;
+        if (iSent <= 0)
+            return false;
+    
+        pchData += iSent;
+        uiSize  -= (size_t) iSent;
+    }
+    
+    return true;
+}
+
+
+/* Helper */
+static std::string MakeHeader(unsigned char uchOperation,
+                              unsigned int uiBitLength, unsigned int uiFlags,
+                              size_t uiSize)
+{
+    char achHeader[DAEMON_HEADER_SIZE];
+    
+    FormatHeader(achHeader, uchOperation, uiBitLength, uiFlags, uiSize);
+    
+    return std::string(achHeader, DAEMON_HEADER_SIZE);
+}
+
+
+/* Helper */
+static std::string MakeRequest(unsigned char uchOperation,
+                               unsigned int uiBitLength, unsigned int uiFlags,
+                               const std::string &pszPayload)
+{
+    return MakeHeader(uchOperation, uiBitLength, uiFlags, pszPayload.size()) +
+           pszPayload;
+}
+
+
+/* Helper */
+static bool ReceiveResponse(int hSocket, unsigned char &uchStatus,
+                            std::string &pszPayload)
+{
+    unsigned int uiBitLength;
+    unsigned int uiFlags;
+    size_t       uiSize;
+    
+    if (!ReceiveHeader(hSocket, uchStatus, uiBitLength, uiFlags, uiSize) ||
+        uiSize > DAEMON_MAX_PAYLOAD_SIZE)
+        return false;
+    
+    pszPayload.resize(uiSize);
+    return uiSize == 0 || ReceiveBytes(hSocket, &pszPayload[0], uiSize);
+}
+
+
+/* Helper */
+static bool IsClosedByDaemon(int hSocket)
+{
+    char    chByte;
+    ssize_t iReceived;
+    
+    do
+        iReceived = recv(hSocket, &chByte, 1, 0);
+    while (iReceived < 0 && errno == EINTR);
+    
+    return iReceived == 0;
+}
+
+
+/* Helper */
+static size_t ResidentKilobytes(pid_t iPid)
+{
+    std::ifstream ifs(("/proc/" + ToString(iPid) + "/status").c_str());
+    std::string   pszLine;
+    
+    while (std::getline(ifs, pszLine))
+    {
+        if (pszLine.compare(0, 6, "VmRSS:") == 0)
+            return (size_t) strtoul(pszLine.c_str() + 6, NULL, 10);
+    }
+    
+    // Not known on this platform
+    return 0;
+}
+
+
+/******************************************************************************
+* @Function		StartDaemon
+*
+* @Description	Start `lzwd` with two workers on a socket in the directory
+*               of the check, and wait until it accepts connections.
+*
+* @Return		pid_t                       Returns process of lzwd,
+*                                           or -1 if it does not start
+******************************************************************************/
+static pid_t StartDaemon()
+{
+    std::string pszSocketPath = SocketPath();
+    pid_t       iPid;
+    int         hSocket;
+    int         hNull;
+    
+    iPid = fork();
+    if (iPid < 0)
+        return -1;
+    
+    if (iPid == 0)
+    {
+        hNull = open("/dev/null", O_WRONLY);
+        if (hNull >= 0)
+            dup2(hNull, STDOUT_FILENO);
+    
+        execl(g_pszDaemonPath.c_str(), g_pszDaemonPath.c_str(),
+              "--socket", pszSocketPath.c_str(), "--workers", "2", (char *) NULL);
+        _exit(127);
+    }
+    
+    for (int i=0; i<100; i++)
+    {
+        hSocket = ConnectDaemon();
+        if (hSocket >= 0)
+        {
+            close(hSocket);
+            return iPid;
+        }
+        usleep(100000);
+    }
+    
+    kill(iPid, SIGKILL);
+    waitpid(iPid, NULL, 0);
+    return -1;
+}
+
+
+/******************************************************************************
+* @Function		StopDaemon
+*
+* @Description	Interrupt `lzwd` and check that it stops cleanly.
+*
+* @Input		pid_t		iPid            Process of lzwd
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void StopDaemon(pid_t iPid)
+{
+    int iStatus = 0;
+    
+    kill(iPid, SIGTERM);
+    Expect(waitpid(iPid, &iStatus, 0) == iPid && WIFEXITED(iStatus) &&
+           WEXITSTATUS(iStatus) == 0, "lzwd stops on SIGTERM");
+}
+
+
+/******************************************************************************
+* @Function		TestClient
+*
+* @Description	Check that lzwd, through its client, compresses every
+*               sample as the library does, and decompresses it back, on
+*               a single connection carrying all requests.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestClient()
+{
+    std::vector<std::string> vpszSamples = MakeSamples();
+    DaemonClient             client(SocketPath());
+    std::string              pszCodes;
+    std::string              pszText;
+    std::string              pszWhat;
+    unsigned int             uiCodeLength;
+    unsigned int             uiFlags;
+    
+    for (size_t b=0; b<g_uiBitLengthCount; b++)
+    {
+        for (int p=PARSE_GREEDY; p<=PARSE_FLEXIBLE; p++)
+        {
+            uiFlags = (p == PARSE_FLEXIBLE) ? LZW_FLAG_FLEXIBLE : 0;
+    
+            for (size_t s=0; s<vpszSamples.size(); s++)
+            {
+                pszWhat = Describe((p == PARSE_FLEXIBLE ? "flexible sample " :
+                                                          "sample ") +
+                                   ToString(s), g_auiBitLengths[b]);
+    
+                Expect(client.Compress(vpszSamples[s], g_auiBitLengths[b],
+                                       (ParseMode) p, pszCodes,
+                                       uiCodeLength) == DAEMON_OK,
+                       pszWhat + ": compress");
+                Expect(pszCodes == Compress(vpszSamples[s], g_auiBitLengths[b],
+                                            uiFlags),
+                       pszWhat + ": same as library");
+                Expect(pszCodes.size() > 4 &&
+                       uiCodeLength == (unsigned char) pszCodes[4],
+                       pszWhat + ": bit length reported");
+    
+                Expect(client.Decompress(pszCodes, 0, pszText) == DAEMON_OK &&
+                       pszText == vpszSamples[s], pszWhat + ": decompress");
+            }
+        }
+    }
+    
+    // Truncated data is refused, and the connection serves on
+    pszCodes = Compress(vpszSamples[3], 12, 0).substr(0, 4);
+    Expect(client.Decompress(pszCodes, 0, pszText) == DAEMON_ERROR,
+           "truncated data refused");
+    Expect(client.Compress(vpszSamples[1], 12, PARSE_GREEDY, pszCodes,
+                           uiCodeLength) == DAEMON_OK &&
+           pszCodes == Compress(vpszSamples[1], 12, 0),
+           "request served after truncated data");
+}
+
+
+/******************************************************************************
+* @Function		TestPipeline
+*
+* @Description	Check that requests sent back to back on one connection,
+*               before any response is read, are answered in order, and
+*               that a request too large is refused before its payload.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestPipeline()
+{
+    std::string   pszText  = MakeText(100000, 7);
+    std::string   pszCodes = Compress(pszText, 12, 0);
+    std::string   pszRequests;
+    std::string   pszPayload;
+    unsigned char uchStatus;
+    int           hSocket;
+    
+    hSocket = ConnectDaemon();
+    Expect(hSocket >= 0, "pipeline: connect");
+    if (hSocket < 0)
+        return;
+    
+    pszRequests = MakeRequest(DAEMON_COMPRESS, 12, 0, pszText) +
+                  MakeRequest(DAEMON_DECOMPRESS, 0, 0, pszCodes) +
+                  MakeRequest('X', 12, 0, "abc") +
+                  MakeRequest(DAEMON_COMPRESS, 9, DAEMON_FLAG_FLEXIBLE, "") +
+                  MakeRequest(DAEMON_COMPRESS, 16, 0, pszText);
+    Expect(SendAll(hSocket, pszRequests), "pipeline: send requests");
+    
+    Expect(ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_OK && pszPayload == pszCodes,
+           "pipeline: first compression");
+    Expect(ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_OK && pszPayload == pszText,
+           "pipeline: decompression");
+    Expect(ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_ERROR, "pipeline: unknown operation refused");
+    Expect(ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_OK &&
+           pszPayload == Compress("", 9, LZW_FLAG_FLEXIBLE),
+           "pipeline: empty payload");
+    Expect(ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_OK && pszPayload == Compress(pszText, 16, 0),
+           "pipeline: last compression");
+    close(hSocket);
+    
+    // Header alone is answered, and connection closed
+    hSocket = ConnectDaemon();
+    Expect(hSocket >= 0 &&
+           SendAll(hSocket, MakeHeader(DAEMON_COMPRESS, 12, 0,
+                                       DAEMON_MAX_PAYLOAD_SIZE + 1)) &&
+           ReceiveResponse(hSocket, uchStatus, pszPayload) &&
+           uchStatus == DAEMON_ERROR && pszPayload == "Request is too large.",
+           "pipeline: too large request refused");
+    Expect(hSocket >= 0 && IsClosedByDaemon(hSocket),
+           "pipeline: too large request closes connection");
+    if (hSocket >= 0)
+        close(hSocket);
+}
+
+
+/******************************************************************************
+* @Function		TestStall
+*
+* @Description	Check that clients stalled within a header, or within a
+*               payload claimed to be as large as accepted, neither block
+*               other clients nor make lzwd allocate the payload claimed.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestStall()
+{
+    static const size_t uiStalledCount = 8;
+    std::vector<int>    vhStalled;
+    std::string         pszText = MakeText(300000, 8);
+    std::string         pszCodes;
+    std::string         pszResult;
+    DaemonClient        client(SocketPath());
+    unsigned int        uiCodeLength;
+    size_t              uiResidentBefore = ResidentKilobytes(g_iDaemonPid);
+    size_t              uiResidentAfter;
+    int                 hSocket;
+    
+    // Half of them stall within the header, half within the payload
+    for (size_t i=0; i<uiStalledCount; i++)
+    {
+        hSocket = ConnectDaemon();
+        Expect(hSocket >= 0, "stall: connect");
+        if (hSocket < 0)
+            continue;
+    
+        if (i % 2 == 0)
+            SendAll(hSocket, MakeHeader(DAEMON_COMPRESS, 12, 0, 0).substr(0, 7));
+        else
+            SendAll(hSocket, MakeHeader(DAEMON_COMPRESS, 12, 0,
+                                        DAEMON_MAX_PAYLOAD_SIZE) +
+                             std::string(1000, 'a'));
+        vhStalled.push_back(hSocket);
+    }
+    
+    Expect(client.Compress(pszText, 12, PARSE_GREEDY, pszCodes,
+                           uiCodeLength) == DAEMON_OK &&
+           pszCodes == Compress(pszText, 12, 0),
+           "stall: other client served");
+    Expect(client.Decompress(pszCodes, 0, pszResult) == DAEMON_OK &&
+           pszResult == pszText, "stall: other client served again");
+    
+    // Claimed payloads take no memory until they arrive
+    uiResidentAfter = ResidentKilobytes(g_iDaemonPid);
+    if (uiResidentBefore > 0 && uiResidentAfter > 0)
+        Expect(uiResidentAfter < uiResidentBefore + 64 * 1024,
+               "stall: claimed payloads not allocated (" +
+               ToString(uiResidentBefore) + " KiB before, " +
+               ToString(uiResidentAfter) + " KiB after)");
+    
+    for (size_t i=0; i<vhStalled.size(); i++)
+        close(vhStalled[i]);
+}
+
+
+/******************************************************************************
+* @Function		TestTimeout
+*
+* @Description	Check that lzwd disconnects a client stalled within a
+*               header once DAEMON_IO_TIMEOUT_SECONDS pass, and not before.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestTimeout()
+{
+    struct timeval tvTimeout;
+    time_t         tStart;
+    time_t         tElapsed;
+    int            hSocket;
+    
+    hSocket = ConnectDaemon();
+    Expect(hSocket >= 0, "timeout: connect");
+    if (hSocket < 0)
+        return;
+    
+    // Do not wait forever if lzwd never disconnects
+    tvTimeout.tv_sec  = DAEMON_IO_TIMEOUT_SECONDS * 2;
+    tvTimeout.tv_usec = 0;
+    setsockopt(hSocket, SOL_SOCKET, SO_RCVTIMEO, &tvTimeout, sizeof(tvTimeout));
+    
+    tStart = time(NULL);
+    SendAll(hSocket, MakeHeader(DAEMON_COMPRESS, 12, 0, 0).substr(0, 7));
+    Expect(IsClosedByDaemon(hSocket), "timeout: stalled client disconnected");
+    
+    tElapsed = time(NULL) - tStart;
+    Expect(tElapsed + 1 >= (time_t) DAEMON_IO_TIMEOUT_SECONDS &&
+           tElapsed <= (time_t) DAEMON_IO_TIMEOUT_SECONDS + 5,
+           "timeout: disconnected after " + ToString(tElapsed) + " seconds");
+    close(hSocket);
+}
+
+
+/******************************************************************************
+* @Function		CheckUtilities
+*
+* @Description	Encode and decode a file by `Encoder` and `Decoder` with
+*               `--daemon`, and check that the file is restored and coded
+*               as without `--daemon`.
+*
+* @Input		string		pszFallback     Message expected if lzwd is
+*                                           not available, or empty if
+*                                           it is running
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void CheckUtilities(const std::string &pszFallback)
+{
+    static const char *apszBitLengths[] = {"auto", "12", "16"};
+    std::string       pszText = MakeText(150000, 9) + MakeRandom(40000, 10);
+    std::string       pszBase = g_pszDirectory + "/sample";
+    std::string       pszLocal = g_pszDirectory + "/local";
+    std::string       pszLog = "\'" + g_pszDirectory + "/log.txt\'";
+    std::string       pszOption;
+    std::string       pszWhat;
+    std::string       pszLogText;
+    
+    WriteFile(pszBase + ".txt", pszText);
+    WriteFile(pszLocal + ".txt", pszText);
+    setenv(DAEMON_SOCKET_ENV, SocketPath().c_str(), 1);
+    
+    for (size_t b=0; b<sizeof(apszBitLengths)/sizeof(apszBitLengths[0]); b++)
+    {
+        for (int p=PARSE_GREEDY; p<=PARSE_FLEXIBLE; p++)
+        {
+            pszOption = (p == PARSE_FLEXIBLE) ? " --flexible" : "";
+            pszWhat   = std::string("utilities with bit length ") +
+                        apszBitLengths[b] + pszOption;
+    
+            Expect(RunCommand("\'" + g_pszEncoderPath + "\' \'" + pszBase +
+                              ".txt\' " + apszBitLengths[b] + pszOption +
+                              " --daemon >/dev/null 2>" + pszLog) == 0,
+                   pszWhat + ": Encoder");
+            pszLogText = ReadFile(g_pszDirectory + "/log.txt");
+            Expect(pszFallback.empty() ? pszLogText.empty() :
+                   pszLogText.find(pszFallback + "encoding locally.") !=
+                   std::string::npos, pszWhat + ": Encoder message");
+    
+            Expect(RunCommand("\'" + g_pszDecoderPath + "\' \'" + pszBase +
+                              ".lzw\' --daemon >/dev/null 2>" + pszLog) == 0,
+                   pszWhat + ": Decoder");
+            pszLogText = ReadFile(g_pszDirectory + "/log.txt");
+            Expect(pszFallback.empty() ? pszLogText.empty() :
+                   pszLogText.find(pszFallback + "decoding locally.") !=
+                   std::string::npos, pszWhat + ": Decoder message");
+    
+            Expect(ReadFile(pszBase + "_decoded.txt") == pszText,
+                   pszWhat + ": file restored");
+    
+            // Same file as coded without lzwd
+            unsetenv(DAEMON_SOCKET_ENV);
+            Expect(RunCommand("\'" + g_pszEncoderPath + "\' \'" + pszLocal +
+                              ".txt\' " + apszBitLengths[b] + pszOption +
+                              " >/dev/null") == 0 &&
+                   ReadFile(pszBase + ".lzw") == ReadFile(pszLocal + ".lzw"),
+                   pszWhat + ": same as local Encoder");
+            setenv(DAEMON_SOCKET_ENV, SocketPath().c_str(), 1);
+        }
+    }
+    
+    unsetenv(DAEMON_SOCKET_ENV);
+}
+
+
+/******************************************************************************
+* @Function		TestUtilities
+*
+* @Description	Check that `Encoder` and `Decoder` hand files over to lzwd.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestUtilities()
+{
+    CheckUtilities("");
+}
+
+
+/******************************************************************************
+* @Function		TestFallback
+*
+* @Description	Check that `Encoder` and `Decoder` code files locally, and
+*               say so, if lzwd is not running.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestFallback()
+{
+    CheckUtilities("lzwd is not available at \'" + SocketPath() + "\'; ");
+}
+
+
+/******************************************************************************
+* @Struct		TestCase
+*
+* @Description	Check run by name.
+******************************************************************************/
+struct TestCase
+{
+    const char    *pszName;       // Name given on commandline
+    void          (*pfnTest)();   // Function performing the check
+    bool          bNeedsDaemon;   // Whether lzwd is started for the check
+};
+
+/* Checks, one CTest test each */
+static const TestCase g_aTests[] = {
+    {"client",      TestClient,     true},
+    {"pipeline",    TestPipeline,   true},
+    {"stall",       TestStall,      true},
+    {"timeout",     TestTimeout,    true},
+    {"utilities",   TestUtilities,  true},
+    {"fallback",    TestFallback,   false}
+};
+static const size_t g_uiTestCount = sizeof(g_aTests) / sizeof(g_aTests[0]);
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName
+    << " <Test> <lzwd Path> <Encoder Path> <Decoder Path>\n"
+    << "\tTest\t\t\t One of:";
+    for (size_t i=0; i<g_uiTestCount; i++)
+        std::cerr << " " << g_aTests[i].pszName;
+    std::cerr << "." << std::endl;
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    const TestCase *pTest = NULL;
+    std::string    pszTest;
+    char           achDirectory[] = "/tmp/lzwdtest-XXXXXX";
+    
+    // Parse commandline arguments
+    if (argc == 5)
+    {
+        pszTest = argv[1];
+        for (size_t i=0; i<g_uiTestCount; i++)
+        {
+            if (pszTest == g_aTests[i].pszName)
+                pTest = &g_aTests[i];
+        }
+    }
+    if (pTest == NULL)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    g_pszDaemonPath  = argv[2];
+    g_pszEncoderPath = argv[3];
+    g_pszDecoderPath = argv[4];
+    
+    // Socket and files of the check live in a directory of their own
+    if (mkdtemp(achDirectory) == NULL)
+    {
+        std::cerr << "Unable to create \'" << achDirectory << "\'!" << std::endl;
+        return -1;
+    }
+    g_pszDirectory = achDirectory;
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Run test
+    if (pTest->bNeedsDaemon)
+    {
+        g_iDaemonPid = StartDaemon();
+        Expect(g_iDaemonPid > 0, "lzwd starts");
+    }
+    if (!pTest->bNeedsDaemon || g_iDaemonPid > 0)
+        pTest->pfnTest();
+    if (g_iDaemonPid > 0)
+        StopDaemon(g_iDaemonPid);
+    RunCommand("rm -rf \'" + g_pszDirectory + "\'");
+    
+    std::cout << pszTest << ": "
+              << (g_uiFailures == 0 ? "passed" : "failed")
+              << std::endl;
+    return g_uiFailures == 0 ? 0 : 1;
+}
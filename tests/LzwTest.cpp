@@ -0,0 +1,908 @@
+/******************************************************************************//*!
+* @File          LzwTest.cpp
+* 
+* @Title         Tests of LZW library.
+* 
+* @Author        Chetan Borse
+* 
+* @Created       03/14/2016
+* 
+* @Platform      ?
+* 
+* @Description   This file implements `lzwtest`, which checks LZW library
+*                through its C interface, against itself and against naive
+*                references. Each check is run by name, so that CTest
+*                reports it apart.
+*
+*//*******************************************************************************/ 
+
+#include <iostream>
+#include <sstream>
+#include <string.h>
+#include <string>
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "lzw.h"
+
+
+/* Bit lengths every check is run with */
+static const unsigned int g_auiBitLengths[] = {LZW_AUTO_BIT_LENGTH, 8, 9, 12, 16};
+static const size_t       g_uiBitLengthCount = sizeof(g_auiBitLengths) /
+                                               sizeof(g_auiBitLengths[0]);
+
+/* Number of failed expectations */
+static unsigned int g_uiFailures = 0;
+
+
+/* Helper */
+static void Expect(bool bIsTrue, const std::string &pszWhat)
+{
+    if (!bIsTrue)
+    {
+        std::cerr << "FAILED: " << pszWhat << std::endl;
+        g_uiFailures++;
+    }
+}
+
+
+/* Helper */
+static std::string ToString(uint64_t u8Value)
+{
+    std::ostringstream oss;
+    
+    oss << u8Value;
+    return oss.str();
+}
+
+
+/* Helper */
+static std::string Describe(const std::string &pszCase, unsigned int uiBitLength)
+{
+    return pszCase + " (bit length " + ToString(uiBitLength) + ")";
+}
+
+
+/* Helper */
+static uint32_t NextRandom(uint32_t &u4State)
+{
+    u4State = u4State * 1103515245u + 12345u;
+    return u4State >> 8;
+}
+
+
+/* Helper */
+static std::string MakeText(size_t uiSize, uint32_t u4Seed)
+{
+    static const char *apszWords[] = {"the ", "LZW ", "code ", "word ", "of ",
+                                      "Trie ", "and ", "dictionary ", "a ",
+                                      "compression\n", "to ", "symbol ",
+                                      "encoder ", "decoder ", "in ", "is "};
+    std::string pszText;
+    
+    while (pszText.size() < uiSize)
+        pszText += apszWords[NextRandom(u4Seed) % 16];
+    pszText.resize(uiSize);
+    
+    return pszText;
+}
+
+
+/* Helper */
+static std::string MakeRandom(size_t uiSize, uint32_t u4Seed)
+{
+    std::string pszData(uiSize, '\0');
+    
+    for (size_t i=0; i<uiSize; i++)
+        pszData[i] = (char) NextRandom(u4Seed);
+    
+    return pszData;
+}
+
+
+/* Helper */
+static std::vector<std::string> MakeSamples()
+{
+    std::vector<std::string> vpszSamples;
+    
+    vpszSamples.push_back("");
+    vpszSamples.push_back("a");
+    vpszSamples.push_back("abababababababababab");
+    vpszSamples.push_back(std::string(5000, 'x'));
+    vpszSamples.push_back(MakeText(1000, 1));
+    vpszSamples.push_back(MakeText(200000, 2));
+    vpszSamples.push_back(MakeRandom(5000, 3));
+    vpszSamples.push_back(MakeText(70000, 4) + MakeRandom(70000, 5) +
+                          MakeText(70000, 6));
+    
+    return vpszSamples;
+}
+
+
+/* Helper */
+static int Compress(const std::string &pszText, std::string &pszCodes,
+                    unsigned int uiBitLength, unsigned int uiFlags=0)
+{
+    size_t uiSize = lzw_compress_bound(pszText.size());
+    int    iStatus;
+    
+    pszCodes.resize(uiSize);
+    iStatus = lzw_compress_ex(pszText.data(), pszText.size(),
+                              &pszCodes[0], &uiSize, uiBitLength, uiFlags);
+    pszCodes.resize(iStatus == LZW_OK ? uiSize : 0);
+    
+    return iStatus;
+}
+
+
+/* Helper */
+static int Decompress(const std::string &pszCodes, std::string &pszText,
+                      size_t uiCapacity, unsigned int uiBitLength)
+{
+    size_t uiSize = uiCapacity;
+    int    iStatus;
+    
+    pszText.resize(uiCapacity + 1);
+    iStatus = lzw_decompress(pszCodes.data(), pszCodes.size(),
+                             &pszText[0], &uiSize, uiBitLength);
+    pszText.resize(iStatus == LZW_OK ? uiSize : 0);
+    
+    return iStatus;
+}
+
+
+/* Helper */
+static std::string ReadStream(lzw_stream *pStream)
+{
+    std::string pszOutput(lzw_stream_pending(pStream), '\0');
+    
+    if (!pszOutput.empty())
+        pszOutput.resize(lzw_stream_read(pStream, &pszOutput[0],
+                                         pszOutput.size()));
+    
+    return pszOutput;
+}
+
+
+/* Helper */
+static bool StreamCompress(const std::string &pszText, std::string &pszCodes,
+                           unsigned int uiBitLength, size_t uiChunkSize,
+                           unsigned int uiFlags=0)
+{
+    lzw_stream *pStream = lzw_stream_create_ex(LZW_COMPRESS, uiBitLength,
+                                               uiFlags);
+    bool       bIsOk    = pStream != NULL;
+    
+    pszCodes.clear();
+    for (size_t i=0; bIsOk && i<pszText.size(); i+=uiChunkSize)
+    {
+        bIsOk = lzw_stream_write(pStream, pszText.data() + i,
+                                 std::min(uiChunkSize, pszText.size() - i))
+                == LZW_OK;
+        pszCodes += ReadStream(pStream);
+    }
+    
+    bIsOk = bIsOk && lzw_stream_finish(pStream) == LZW_OK;
+    pszCodes += ReadStream(pStream);
+    
+    // No further input is accepted once finished
+    bIsOk = bIsOk && lzw_stream_write(pStream, "a", 1) == LZW_ERROR_STATE;
+    lzw_stream_destroy(pStream);
+    
+    return bIsOk;
+}
+
+
+/* Helper */
+static bool StreamDecompress(const std::string &pszCodes, std::string &pszText,
+                             size_t uiChunkSize)
+{
+    lzw_stream *pStream = lzw_stream_create(LZW_DECOMPRESS, 0);
+    bool       bIsOk    = pStream != NULL;
+    
+    pszText.clear();
+    for (size_t i=0; bIsOk && i<pszCodes.size(); i+=uiChunkSize)
+    {
+        bIsOk = lzw_stream_write(pStream, pszCodes.data() + i,
+                                 std::min(uiChunkSize, pszCodes.size() - i))
+                == LZW_OK;
+        pszText += ReadStream(pStream);
+    }
+    
+    bIsOk = bIsOk && lzw_stream_finish(pStream) == LZW_OK;
+    if (bIsOk)
+        pszText += ReadStream(pStream);
+    lzw_stream_destroy(pStream);
+    
+    return bIsOk;
+}
+
+
+/******************************************************************************
+* @Function		TestRoundTrip
+*
+* @Description	Check that decompression restores every sample compressed
+*               with every bit length, within lzw_compress_bound(), and
+*               that a too small buffer is refused.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestRoundTrip()
+{
+    std::vector<std::string> vpszSamples = MakeSamples();
+    std::string              pszCodes;
+    std::string              pszText;
+    std::string              pszWhat;
+    size_t                   uiSize;
+    
+    for (size_t s=0; s<vpszSamples.size(); s++)
+    {
+        const std::string &pszSample = vpszSamples[s];
+    
+        for (size_t b=0; b<g_uiBitLengthCount; b++)
+        {
+            pszWhat = Describe("round trip of sample " + ToString(s),
+                               g_auiBitLengths[b]);
+    
+            Expect(Compress(pszSample, pszCodes, g_auiBitLengths[b]) == LZW_OK,
+                   pszWhat + ": compress");
+            Expect(pszCodes.size() <= lzw_compress_bound(pszSample.size()),
+                   pszWhat + ": compress bound");
+            Expect(Decompress(pszCodes, pszText, pszSample.size(), 0) == LZW_OK &&
+                   pszText == pszSample, pszWhat + ": decompress");
+    
+            // Output one byte short of compressed data is refused,
+            // reporting the size required
+            if (!pszCodes.empty())
+            {
+                uiSize = pszCodes.size() - 1;
+                Expect(lzw_compress(pszSample.data(), pszSample.size(),
+                                    &pszCodes[0], &uiSize, g_auiBitLengths[b])
+                       == LZW_ERROR_BUFFER && uiSize == pszCodes.size(),
+                       pszWhat + ": small buffer");
+            }
+        }
+    }
+}
+
+
+/******************************************************************************
+* @Function		TestStream
+*
+* @Description	Check that a compressing stream fed in chunks writes what
+*               the one-shot call writes, and that a decompressing stream
+*               fed in chunks restores the text.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestStream()
+{
+    static const size_t      auiChunkSizes[] = {1, 7, 4096, 100000};
+    std::vector<std::string> vpszSamples = MakeSamples();
+    std::string              pszOneShot;
+    std::string              pszCodes;
+    std::string              pszText;
+    std::string              pszWhat;
+    size_t                   uiChunkSize;
+    
+    for (size_t s=0; s<vpszSamples.size(); s++)
+    {
+        const std::string &pszSample = vpszSamples[s];
+    
+        for (size_t b=0; b<g_uiBitLengthCount; b++)
+        {
+            pszWhat = Describe("stream of sample " + ToString(s),
+                               g_auiBitLengths[b]);
+            uiChunkSize = auiChunkSizes[(s + b) % 4];
+    
+            Expect(Compress(pszSample, pszOneShot, g_auiBitLengths[b]) == LZW_OK,
+                   pszWhat + ": one-shot compress");
+            Expect(StreamCompress(pszSample, pszCodes, g_auiBitLengths[b],
+                                  uiChunkSize) && pszCodes == pszOneShot,
+                   pszWhat + ": same as one-shot");
+            Expect(StreamDecompress(pszOneShot, pszText, uiChunkSize) &&
+                   pszText == pszSample, pszWhat + ": stream decompress");
+        }
+    }
+    
+    // Data cut inside a code is reported on finish
+    Compress("abc", pszCodes, 12);
+    Expect(!StreamDecompress(pszCodes.substr(0, pszCodes.size() - 1),
+                             pszText, 64), "stream: truncated code reported");
+}
+
+
+/******************************************************************************
+* @Function		TestFlexible
+*
+* @Description	Check that flexible parsing is decoded like greedy parsing,
+*               that its output is never larger and that it is smaller
+*               once Trie is full.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestFlexible()
+{
+    std::vector<std::string> vpszSamples = MakeSamples();
+    std::string              pszGreedy;
+    std::string              pszFlexible;
+    std::string              pszCodes;
+    std::string              pszText;
+    std::string              pszWhat;
+    
+    for (size_t s=0; s<vpszSamples.size(); s++)
+    {
+        const std::string &pszSample = vpszSamples[s];
+    
+        for (size_t b=0; b<g_uiBitLengthCount; b++)
+        {
+            pszWhat = Describe("flexible parsing of sample " + ToString(s),
+                               g_auiBitLengths[b]);
+    
+            Expect(Compress(pszSample, pszGreedy, g_auiBitLengths[b]) == LZW_OK &&
+                   Compress(pszSample, pszFlexible, g_auiBitLengths[b],
+                            LZW_FLAG_FLEXIBLE) == LZW_OK,
+                   pszWhat + ": compress");
+            Expect(Decompress(pszFlexible, pszText, pszSample.size(), 0) == LZW_OK &&
+                   pszText == pszSample, pszWhat + ": decompress");
+            Expect(pszFlexible.size() <= pszGreedy.size(),
+                   pszWhat + ": not larger than greedy parsing");
+            Expect(StreamCompress(pszSample, pszCodes, g_auiBitLengths[b], 4096,
+                                  LZW_FLAG_FLEXIBLE) && pszCodes == pszFlexible,
+                   pszWhat + ": stream same as one-shot");
+        }
+    }
+    
+    // Text filling Trie early gains from flexible parsing
+    Compress(vpszSamples[5], pszGreedy, 12);
+    Compress(vpszSamples[5], pszFlexible, 12, LZW_FLAG_FLEXIBLE);
+    Expect(pszFlexible.size() < pszGreedy.size(),
+           "flexible parsing: smaller once Trie is full");
+}
+
+
+/******************************************************************************
+* @Function		TestBitLength
+*
+* @Description	Check that bit length selected automatically is recorded in
+*               the header, where streams learn it from, and that bit
+*               lengths other than auto and 8 to 16 are refused.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestBitLength()
+{
+    std::string  pszText = MakeText(200000, 2);
+    std::string  pszCodes;
+    lzw_stream   *pStream;
+    unsigned int uiBitLength;
+    size_t       uiSize;
+    
+    // Header is "LZW", format version and bit length
+    Expect(Compress(pszText, pszCodes, LZW_AUTO_BIT_LENGTH) == LZW_OK &&
+           pszCodes.size() > 5 && pszCodes.compare(0, 3, "LZW") == 0,
+           "bit length: header");
+    uiBitLength = pszCodes.size() > 5 ? (unsigned char) pszCodes[4] : 0;
+    Expect(uiBitLength >= LZW_MIN_BIT_LENGTH && uiBitLength <= LZW_MAX_BIT_LENGTH,
+           "bit length: auto selects 8 to 16");
+    
+    // Compressing stream knows bit length once the text is sampled
+    pStream = lzw_stream_create(LZW_COMPRESS, LZW_AUTO_BIT_LENGTH);
+    lzw_stream_write(pStream, pszText.data(), 1000);
+    Expect(lzw_stream_bit_length(pStream) == 0, "bit length: unknown while sampling");
+    lzw_stream_write(pStream, pszText.data() + 1000, pszText.size() - 1000);
+    lzw_stream_finish(pStream);
+    Expect(lzw_stream_bit_length(pStream) == uiBitLength,
+           "bit length: compressing stream");
+    lzw_stream_destroy(pStream);
+    
+    // Decompressing stream learns it from the header
+    pStream = lzw_stream_create(LZW_DECOMPRESS, LZW_AUTO_BIT_LENGTH);
+    lzw_stream_write(pStream, pszCodes.data(), 4);
+    Expect(lzw_stream_bit_length(pStream) == 0, "bit length: partial header");
+    lzw_stream_write(pStream, pszCodes.data() + 4, pszCodes.size() - 4);
+    Expect(lzw_stream_bit_length(pStream) == uiBitLength,
+           "bit length: decompressing stream");
+    lzw_stream_destroy(pStream);
+    Expect(!StreamDecompress(pszCodes.substr(0, 3), pszText, 64),
+           "bit length: truncated header reported");
+    
+    // Bit lengths other than auto and 8 to 16 are refused
+    for (uiBitLength=1; uiBitLength<=32; uiBitLength++)
+    {
+        if (uiBitLength >= LZW_MIN_BIT_LENGTH && uiBitLength <= LZW_MAX_BIT_LENGTH)
+            continue;
+    
+        uiSize = pszCodes.size();
+        Expect(lzw_compress("a", 1, &pszCodes[0], &uiSize, uiBitLength)
+               == LZW_ERROR_PARAM &&
+               lzw_decompress(pszCodes.data(), 8, &pszText[0], &uiSize,
+                              uiBitLength) == LZW_ERROR_PARAM &&
+               lzw_stream_create(LZW_COMPRESS, uiBitLength) == NULL &&
+               lzw_stream_create(LZW_DECOMPRESS, uiBitLength) == NULL,
+               Describe("bit length: refused", uiBitLength));
+    }
+}
+
+
+/******************************************************************************
+* @Function		LegacyCompress
+*
+* @Description	Compress a text as versions before 1.3 did: 16 bit codes
+*               in big endian, no header, no control codes, and no new
+*               word once the Map of 2^bit length codes is full.
+*
+* @Input		string&		pszText         Text to be compressed
+*
+* @Input		uint		uiBitLength     Bit length limiting the Map
+*
+* @Return		string                      Compressed data
+******************************************************************************/
+static std::string LegacyCompress(const std::string &pszText,
+                                  unsigned int uiBitLength)
+{
+    std::map<std::string, uint32_t> mpuiWords;
+    std::string                     pszWord;
+    std::string                     pszCodes;
+    uint32_t                        u4Code         = 256;
+    uint32_t                        u4MaxTableSize = 1u << uiBitLength;
+    uint32_t                        u4Output;
+    
+    for (uint32_t c=0; c<256; c++)
+        mpuiWords[std::string(1, (char) c)] = c;
+    
+    for (size_t i=0; i<=pszText.size(); i++)
+    {
+        if (i < pszText.size() && mpuiWords.count(pszWord + pszText[i]))
+        {
+            pszWord += pszText[i];
+            continue;
+        }
+    
+        if (pszWord.empty())
+            break;
+    
+        u4Output  = mpuiWords[pszWord];
+        pszCodes += (char) (u4Output >> 8);
+        pszCodes += (char) (u4Output & 0xff);
+    
+        if (i < pszText.size())
+        {
+            if (u4Code < u4MaxTableSize)
+                mpuiWords[pszWord + pszText[i]] = u4Code++;
+            pszWord = pszText[i];
+        }
+    }
+    
+    return pszCodes;
+}
+
+
+/******************************************************************************
+* @Function		TestLegacy
+*
+* @Description	Check that data written without header is decoded, with
+*               the bit length given to the decoder limiting its Map.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestLegacy()
+{
+    static const unsigned int auiBitLengths[] = {LZW_AUTO_BIT_LENGTH, 9, 12, 16};
+    std::vector<std::string>  vpszSamples = MakeSamples();
+    std::string               pszCodes;
+    std::string               pszText;
+    std::string               pszWhat;
+    unsigned int              uiBitLength;
+    
+    for (size_t s=1; s<vpszSamples.size(); s++)
+    {
+        // Only data starting with a zero byte is taken for legacy data
+        std::string pszSample = std::string(1, '\0') + vpszSamples[s];
+    
+        for (size_t b=0; b<4; b++)
+        {
+            uiBitLength = auiBitLengths[b] == LZW_AUTO_BIT_LENGTH ?
+                          16 : auiBitLengths[b];
+            pszWhat  = Describe("legacy sample " + ToString(s), auiBitLengths[b]);
+            pszCodes = LegacyCompress(pszSample, uiBitLength);
+    
+            Expect(Decompress(pszCodes, pszText, pszSample.size(),
+                              auiBitLengths[b]) == LZW_OK &&
+                   pszText == pszSample, pszWhat + ": decompress");
+        }
+    }
+}
+
+
+/******************************************************************************
+* @Function		TestFlush
+*
+* @Description	Check that every message of a stream is decoded as soon as
+*               the codes up to its sync flush arrive, and that later
+*               messages are compressed with words of earlier ones.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestFlush()
+{
+    std::vector<std::string> vpszMessages;
+    lzw_stream               *pEncoder;
+    lzw_stream               *pDecoder;
+    std::string              pszCodes;
+    std::string              pszSeparate;
+    std::string              pszWhat;
+    size_t                   uiFlushedSize;
+    size_t                   uiSeparateSize;
+    uint32_t                 u4Seed = 11;
+    
+    for (size_t m=0; m<100; m++)
+        vpszMessages.push_back(MakeText(1000 + NextRandom(u4Seed) % 3000, m));
+    
+    // An empty message and a flush right after another one
+    vpszMessages.insert(vpszMessages.begin() + 50, 2, std::string());
+    
+    for (size_t b=0; b<g_uiBitLengthCount; b++)
+    {
+        for (unsigned int uiFlags=0; uiFlags<=LZW_FLAG_FLEXIBLE;
+             uiFlags+=LZW_FLAG_FLEXIBLE)
+        {
+            pszWhat  = Describe(uiFlags ? "flexible flush" : "flush",
+                                g_auiBitLengths[b]);
+            pEncoder = lzw_stream_create_ex(LZW_COMPRESS, g_auiBitLengths[b],
+                                            uiFlags);
+            pDecoder = lzw_stream_create(LZW_DECOMPRESS, LZW_AUTO_BIT_LENGTH);
+            uiFlushedSize  = 0;
+            uiSeparateSize = 0;
+    
+            for (size_t m=0; m<vpszMessages.size(); m++)
+            {
+                Expect(lzw_stream_write(pEncoder, vpszMessages[m].data(),
+                                        vpszMessages[m].size()) == LZW_OK &&
+                       lzw_stream_flush(pEncoder) == LZW_OK,
+                       pszWhat + ": compress");
+                pszCodes       = ReadStream(pEncoder);
+                uiFlushedSize += pszCodes.size();
+    
+                // Decoder delivers the whole message right away
+                Expect(lzw_stream_write(pDecoder, pszCodes.data(),
+                                        pszCodes.size()) == LZW_OK &&
+                       ReadStream(pDecoder) == vpszMessages[m],
+                       pszWhat + ": message " + ToString(m));
+    
+                Compress(vpszMessages[m], pszSeparate, g_auiBitLengths[b],
+                         uiFlags);
+                uiSeparateSize += pszSeparate.size();
+            }
+    
+            // Nothing is left to decode after the last flush
+            Expect(lzw_stream_finish(pEncoder) == LZW_OK, pszWhat + ": finish");
+            pszCodes = ReadStream(pEncoder);
+            Expect(lzw_stream_write(pDecoder, pszCodes.data(),
+                                    pszCodes.size()) == LZW_OK &&
+                   lzw_stream_finish(pDecoder) == LZW_OK &&
+                   ReadStream(pDecoder).empty(), pszWhat + ": end of stream");
+            lzw_stream_destroy(pEncoder);
+            lzw_stream_destroy(pDecoder);
+    
+            // Codes of 8 bits learn no words
+            if (g_auiBitLengths[b] != 8)
+                Expect(uiFlushedSize < uiSeparateSize,
+                       pszWhat + ": dictionary kept across messages");
+        }
+    }
+}
+
+
+/* Helper */
+static int CollectMatch(void *pOpaque, uint64_t u8Offset)
+{
+    ((std::vector<uint64_t> *) pOpaque)->push_back(u8Offset);
+    return 0;
+}
+
+
+/******************************************************************************
+* @Function		TestSearch
+*
+* @Description	Check that lzw_search() reports the same occurrences,
+*               overlapping ones included, as a naive search of the text.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestSearch()
+{
+    std::vector<std::string> vpszSamples = MakeSamples();
+    std::vector<std::string> vpszPatterns;
+    std::vector<uint64_t>    vu8Expected;
+    std::vector<uint64_t>    vu8Found;
+    std::string              pszCodes;
+    std::string              pszWhat;
+    uint64_t                 u8Count;
+    uint32_t                 u4Seed = 8;
+    
+    for (size_t s=0; s<vpszSamples.size(); s++)
+    {
+        const std::string &pszSample = vpszSamples[s];
+    
+        // Patterns cut from the text, plus some that may not occur
+        vpszPatterns.clear();
+        vpszPatterns.push_back("xx");
+        vpszPatterns.push_back("word of");
+        vpszPatterns.push_back("zzz");
+        for (size_t p=0; p<12 && !pszSample.empty(); p++)
+            vpszPatterns.push_back(pszSample.substr(NextRandom(u4Seed) %
+                                                    pszSample.size(),
+                                                    1 + p * p));
+    
+        for (size_t b=0; b<g_uiBitLengthCount; b++)
+        {
+            pszWhat = Describe("search of sample " + ToString(s),
+                               g_auiBitLengths[b]);
+            Compress(pszSample, pszCodes, g_auiBitLengths[b]);
+    
+            for (size_t p=0; p<vpszPatterns.size(); p++)
+            {
+                vu8Expected.clear();
+                for (size_t i=pszSample.find(vpszPatterns[p]);
+                     i!=std::string::npos; i=pszSample.find(vpszPatterns[p], i+1))
+                    vu8Expected.push_back(i);
+    
+                vu8Found.clear();
+                Expect(lzw_search(pszCodes.data(), pszCodes.size(),
+                                  vpszPatterns[p].data(), vpszPatterns[p].size(),
+                                  0, CollectMatch, &vu8Found, &u8Count) == LZW_OK &&
+                       vu8Found == vu8Expected && u8Count == vu8Expected.size(),
+                       pszWhat + ": pattern " + ToString(p));
+            }
+        }
+    }
+    
+    // Empty pattern is refused
+    Expect(lzw_search(pszCodes.data(), pszCodes.size(), "", 0, 0,
+                      NULL, NULL, &u8Count) == LZW_ERROR_PARAM,
+           "search: empty pattern refused");
+}
+
+
+/******************************************************************************
+* @Function		TestStored
+*
+* @Description	Check that data LZW would expand is stored as is, costing
+*               at most 5 bytes per block or sync flush, and that stored
+*               blocks mixed with coded ones decode.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestStored()
+{
+    static const unsigned int auiBitLengths[]   = {LZW_AUTO_BIT_LENGTH, 9, 12, 16};
+    static const size_t       auiMessageSizes[] = {10, 1024};
+    std::string               pszRandom = MakeRandom(300000, 9);
+    std::string               pszMixed  = MakeText(50000, 10) + pszRandom +
+                                          MakeText(50000, 10);
+    lzw_stream                *pStream;
+    std::string               pszCodes;
+    std::string               pszText;
+    std::string               pszWhat;
+    size_t                    uiMessageSize;
+    size_t                    uiCount;
+    
+    for (size_t b=0; b<4; b++)
+    {
+        pszWhat = Describe("stored", auiBitLengths[b]);
+    
+        Expect(Compress(pszRandom, pszCodes, auiBitLengths[b]) == LZW_OK &&
+               pszCodes.size() <= lzw_compress_bound(pszRandom.size()) &&
+               pszCodes.size() < pszRandom.size() + pszRandom.size() / 1000,
+               pszWhat + ": random data size");
+        Expect(Decompress(pszCodes, pszText, pszRandom.size(), 0) == LZW_OK &&
+               pszText == pszRandom, pszWhat + ": random data");
+        Expect(StreamDecompress(pszCodes, pszText, 1000) &&
+               pszText == pszRandom, pszWhat + ": random data streamed");
+    
+        // Data cut inside a stored block is reported on finish;
+        // auto may select 8 bit codes, which need no stored blocks
+        if ((unsigned char) pszCodes[4] > 8)
+            Expect(!StreamDecompress(pszCodes.substr(0, pszCodes.size() / 2),
+                                     pszText, 1000),
+                   pszWhat + ": truncated block reported");
+    
+        Expect(Compress(pszMixed, pszCodes, auiBitLengths[b]) == LZW_OK &&
+               pszCodes.size() < pszMixed.size(), pszWhat + ": mixed data size");
+        Expect(Decompress(pszCodes, pszText, pszMixed.size(), 0) == LZW_OK &&
+               pszText == pszMixed, pszWhat + ": mixed data");
+        Expect(StreamDecompress(pszCodes, pszText, 777) &&
+               pszText == pszMixed, pszWhat + ": mixed data streamed");
+    
+        // Random messages, each flushed, whether stored right away
+        // for their entropy or after trial encoding
+        for (size_t m=0; m<2; m++)
+        {
+            uiMessageSize = auiMessageSizes[m];
+            uiCount       = pszRandom.size() / uiMessageSize;
+            pStream       = lzw_stream_create(LZW_COMPRESS, auiBitLengths[b]);
+            pszCodes.clear();
+    
+            for (size_t i=0; i<uiCount; i++)
+            {
+                lzw_stream_write(pStream, pszRandom.data() + i * uiMessageSize,
+                                 uiMessageSize);
+                lzw_stream_flush(pStream);
+                pszCodes += ReadStream(pStream);
+            }
+            lzw_stream_finish(pStream);
+            pszCodes += ReadStream(pStream);
+            lzw_stream_destroy(pStream);
+    
+            pszText = pszRandom.substr(0, uiCount * uiMessageSize);
+            Expect(pszCodes.size() <= lzw_compress_bound(pszText.size()) +
+                                      5 * uiCount,
+                   pszWhat + ": flushed messages of " +
+                   ToString(uiMessageSize) + " bytes size");
+            Expect(StreamDecompress(pszCodes, pszText, 4096) &&
+                   pszText == pszRandom.substr(0, uiCount * uiMessageSize),
+                   pszWhat + ": flushed messages of " +
+                   ToString(uiMessageSize) + " bytes");
+        }
+    }
+}
+
+
+/******************************************************************************
+* @Function		TestBatch
+*
+* @Description	Check that lzw_compress_batch() writes every buffer exactly
+*               as lzw_compress_ex() does, whatever the number of lanes.
+*
+* @Return		void                        Returns nothing
+******************************************************************************/
+static void TestBatch()
+{
+    static const unsigned int auiLanes[] = {0, 1, 3, 8, LZW_MAX_LANES};
+    std::vector<std::string>  vpszSamples = MakeSamples();
+    size_t                    uiCount = vpszSamples.size();
+    std::vector<const void *> vpSources(uiCount);
+    std::vector<size_t>       vuiSourceSizes(uiCount);
+    std::vector<std::string>  vpszSingle(uiCount);
+    std::vector<std::string>  vpszBatch(uiCount);
+    std::vector<void *>       vpDestinations(uiCount);
+    std::vector<size_t>       vuiSizes(uiCount);
+    std::string               pszWhat;
+    
+    for (size_t s=0; s<uiCount; s++)
+    {
+        vpSources[s]      = vpszSamples[s].data();
+        vuiSourceSizes[s] = vpszSamples[s].size();
+    }
+    
+    for (size_t b=0; b<g_uiBitLengthCount; b++)
+    {
+        for (unsigned int uiFlags=0; uiFlags<=LZW_FLAG_FLEXIBLE;
+             uiFlags+=LZW_FLAG_FLEXIBLE)
+        {
+            for (size_t s=0; s<uiCount; s++)
+                Compress(vpszSamples[s], vpszSingle[s], g_auiBitLengths[b],
+                         uiFlags);
+    
+            for (size_t l=0; l<sizeof(auiLanes)/sizeof(auiLanes[0]); l++)
+            {
+                pszWhat = Describe((uiFlags ? "flexible batch of " : "batch of ") +
+                                   ToString(auiLanes[l]) + " lanes",
+                                   g_auiBitLengths[b]);
+    
+                for (size_t s=0; s<uiCount; s++)
+                {
+                    vuiSizes[s] = lzw_compress_bound(vuiSourceSizes[s]);
+                    vpszBatch[s].assign(vuiSizes[s], '\0');
+                    vpDestinations[s] = &vpszBatch[s][0];
+                }
+    
+                Expect(lzw_compress_batch(uiCount, &vpSources[0],
+                                          &vuiSourceSizes[0], &vpDestinations[0],
+                                          &vuiSizes[0], g_auiBitLengths[b],
+                                          uiFlags, auiLanes[l]) == LZW_OK,
+                       pszWhat + ": compress");
+    
+                for (size_t s=0; s<uiCount; s++)
+                {
+                    vpszBatch[s].resize(vuiSizes[s]);
+                    Expect(vpszBatch[s] == vpszSingle[s],
+                           pszWhat + ": sample " + ToString(s));
+                }
+            }
+        }
+    }
+    
+    // A too small buffer is reported, the others are still written
+    for (size_t s=0; s<uiCount; s++)
+    {
+        vuiSizes[s] = lzw_compress_bound(vuiSourceSizes[s]);
+        vpszBatch[s].assign(vuiSizes[s], '\0');
+        vpDestinations[s] = &vpszBatch[s][0];
+        Compress(vpszSamples[s], vpszSingle[s], 12);
+    }
+    vuiSizes[1] = 1;
+    Expect(lzw_compress_batch(uiCount, &vpSources[0], &vuiSourceSizes[0],
+                              &vpDestinations[0], &vuiSizes[0], 12, 0, 0)
+           == LZW_ERROR_BUFFER, "batch: small buffer reported");
+    Expect(vuiSizes[1] == vpszSingle[1].size(), "batch: required size");
+    Expect(vuiSizes[2] == vpszSingle[2].size() &&
+           vpszBatch[2].compare(0, vuiSizes[2], vpszSingle[2]) == 0,
+           "batch: other buffers written");
+    
+    Expect(lzw_compress_batch(uiCount, &vpSources[0], &vuiSourceSizes[0],
+                              &vpDestinations[0], &vuiSizes[0], 12, 0,
+                              LZW_MAX_LANES + 1) == LZW_ERROR_PARAM,
+           "batch: too many lanes refused");
+}
+
+
+/******************************************************************************
+* @Struct		TestCase
+*
+* @Description	Check run by name.
+******************************************************************************/
+struct TestCase
+{
+    const char    *pszName;       // Name given on commandline
+    void          (*pfnTest)();   // Function performing the check
+};
+
+/* Checks, one CTest test each */
+static const TestCase g_aTests[] = {
+    {"roundtrip",   TestRoundTrip},
+    {"flexible",    TestFlexible},
+    {"bitlength",   TestBitLength},
+    {"legacy",      TestLegacy},
+    {"flush",       TestFlush},
+    {"search",      TestSearch},
+    {"stored",      TestStored},
+    {"batch",       TestBatch},
+    {"stream",      TestStream}
+};
+static const size_t g_uiTestCount = sizeof(g_aTests) / sizeof(g_aTests[0]);
+
+
+/* Helper */
+void ShowUsage(std::string pszExecutableName)
+{
+    std::cerr << "Usage: " << pszExecutableName << " <Test>\n"
+    << "\tTest\t\t\t One of:";
+    for (size_t i=0; i<g_uiTestCount; i++)
+        std::cerr << " " << g_aTests[i].pszName;
+    std::cerr << "." << std::endl;
+}
+
+
+/* Entry point */
+int main(int argc, const char *argv[])
+{
+    std::string pszTest;
+    
+    // Parse commandline arguments
+    if (argc != 2)
+    {
+        ShowUsage(argv[0]);
+        return -1;
+    }
+    pszTest = argv[1];
+    
+    // Run test
+    for (size_t i=0; i<g_uiTestCount; i++)
+    {
+        if (pszTest != g_aTests[i].pszName)
+            continue;
+    
+        g_aTests[i].pfnTest();
+        std::cout << pszTest << ": "
+                  << (g_uiFailures == 0 ? "passed" : "failed")
+                  << std::endl;
+        return g_uiFailures == 0 ? 0 : 1;
+    }
+    
+    ShowUsage(argv[0]);
+    return -1;
+}